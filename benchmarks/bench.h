@@ -0,0 +1,90 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+	struct state {
+		using clock = std::chrono::steady_clock;
+
+		struct iterator {
+			std::size_t remaining;
+			state* owner;
+
+			bool operator!=(const iterator& /*other*/) {
+				if (remaining == 0) {
+					owner->m_end = clock::now();
+					return false;
+				}
+				return true;
+			}
+
+			void operator++() { remaining--; }
+			int operator*() const { return 0; }
+		};
+
+		explicit state(std::size_t iterations) : m_iterations(iterations) {}
+
+		iterator begin() {
+			m_start = clock::now();
+			return { m_iterations, this };
+		}
+
+		iterator end() { return { 0, this }; }
+
+		void set_items_per_iteration(std::size_t items) noexcept { m_items_per_iteration = items; }
+		void skip(std::string reason) { m_skip_reason = std::move(reason); }
+
+		[[nodiscard]] std::size_t get_iterations() const noexcept { return m_iterations; }
+		[[nodiscard]] std::size_t get_items_per_iteration() const noexcept { return m_items_per_iteration; }
+		[[nodiscard]] const std::string& get_skip_reason() const noexcept { return m_skip_reason; }
+		[[nodiscard]] double elapsed_ns() const {
+			return std::chrono::duration<double, std::nano>(m_end - m_start).count();
+		}
+
+	private:
+		std::size_t m_iterations;
+		std::size_t m_items_per_iteration = 1;
+		std::string m_skip_reason;
+		clock::time_point m_start{};
+		clock::time_point m_end{};
+	};
+
+	using function = std::function<void(state&)>;
+
+	struct entry {
+		std::string name;
+		function run;
+	};
+
+	inline std::vector<entry>& registry() {
+		static std::vector<entry> entries;
+		return entries;
+	}
+
+	struct registrar {
+		registrar(const char* name, function run) {
+			registry().push_back({ name, std::move(run) });
+		}
+	};
+
+	template <typename T>
+	inline void do_not_optimize(const T& value) {
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+
+	inline void clobber_memory() {
+		asm volatile("" : : : "memory");
+	}
+}
+
+#define SGW_BENCH_CONCAT_IMPL(a, b) a##b
+#define SGW_BENCH_CONCAT(a, b) SGW_BENCH_CONCAT_IMPL(a, b)
+#define SGW_BENCHMARK(name) \
+	static void name(bench::state& state); \
+	static const bench::registrar SGW_BENCH_CONCAT(name, _registrar)(#name, name); \
+	static void name(bench::state& state)
@@ -0,0 +1,115 @@
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include "bench.h"
+#include "bench_context.h"
+
+namespace {
+	// written once to the temp directory and removed again at exit; the path stays empty when
+	// the image could not be written
+	struct sample_image {
+		sample_image() {
+			std::error_code error;
+			auto file = (std::filesystem::temp_directory_path(error) / "sgw_bench_sample.bmp").string();
+			if (error) {
+				return;
+			}
+
+			auto* surface = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_RGBA32);
+			if (surface == nullptr) {
+				return;
+			}
+
+			auto saved = SDL_FillRect(surface, nullptr, 0xFF00FF80U) == 0 && SDL_SaveBMP(surface, file.c_str()) == 0;
+			SDL_FreeSurface(surface);
+
+			if (saved) {
+				path = file;
+			}
+			else {
+				std::filesystem::remove(file, error);
+			}
+		}
+
+		sample_image(const sample_image&) = delete;
+		sample_image& operator=(const sample_image&) = delete;
+
+		~sample_image() {
+			if (!path.empty()) {
+				std::error_code error;
+				std::filesystem::remove(path, error);
+			}
+		}
+
+		std::string path;
+	};
+
+	const std::string& sample_image_path() {
+		static const sample_image sample;
+		return sample.path;
+	}
+}
+
+SGW_BENCHMARK(image_manager_load_image_bmp_64) {
+	const auto& path = sample_image_path();
+	if (path.empty()) {
+		state.skip("could not write the sample image");
+		return;
+	}
+
+	for ([[maybe_unused]] auto _ : state) {
+		auto surface = sgw::image_manager::load_image(path);
+		bench::do_not_optimize(surface);
+	}
+}
+
+SGW_BENCHMARK(image_manager_get_image) {
+	if (sample_image_path().empty()) {
+		state.skip("could not write the sample image");
+		return;
+	}
+
+	auto& ctx = bench::get_context();
+	auto image = ctx.images.add_image(sample_image_path());
+
+	for ([[maybe_unused]] auto _ : state) {
+		const auto& surface = ctx.images.get_image(image);
+		bench::do_not_optimize(surface);
+	}
+
+	ctx.images.release_image(image);
+}
+
+SGW_BENCHMARK(font_render_blended) {
+	auto& ctx = bench::get_context();
+	if (ctx.font_path.empty()) {
+		state.skip("no font, pass --font or set SGW_BENCH_FONT");
+		return;
+	}
+
+	sdl::font font(ctx.font_path, 16);
+	for ([[maybe_unused]] auto _ : state) {
+		auto surface = font.render_blended("Score: 1234567", { 255, 255, 255, 255 });
+		bench::do_not_optimize(surface);
+	}
+}
+
+SGW_BENCHMARK(font_glyph_cache_draw) {
+	auto& ctx = bench::get_context();
+	if (ctx.font_path.empty()) {
+		state.skip("no font, pass --font or set SGW_BENCH_FONT");
+		return;
+	}
+
+	sdl::font font(ctx.font_path, 16);
+	sgw::glyph_cache glyphs(font, ctx.renderer);
+	std::size_t counter = 0;
+
+	for ([[maybe_unused]] auto _ : state) {
+		glyphs.draw("Score: 1234567", SDL_FPoint{ 10.f, 10.f }, SDL_Color{ 255, 255, 255, 255 });
+		if (++counter % 256 == 0) {
+			ctx.renderer.present();
+		}
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <memory>
+#include <string>
+#include "sgw.h"
+
+namespace bench {
+
+	struct context {
+		static constexpr int window_w = 1280;
+		static constexpr int window_h = 720;
+
+		context()
+			: lib(sdl::lib::init_video | sdl::lib::init_events),
+			  images(IMG_INIT_PNG),
+			  window("sgw benchmarks", 0, 0, window_w, window_h, 0),
+			  renderer(window, -1, SDL_RENDERER_SOFTWARE) {
+		}
+
+		sdl::lib lib;
+		sgw::font_manager fonts;
+		sgw::image_manager images;
+		sdl::window window;
+		sdl::renderer renderer;
+		std::string font_path;
+		std::string scratch_dir;
+	};
+
+	context& get_context();
+}
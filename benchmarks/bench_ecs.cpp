@@ -0,0 +1,53 @@
+#include <entt/entt.hpp>
+#include "bench.h"
+#include "sgw.h"
+#include "game/components.h"
+#include "game/particle_pool.h"
+
+namespace {
+	constexpr std::size_t entity_count = 100000;
+
+	void populate(entt::registry& registry) {
+		for (std::size_t i = 0; i < entity_count; i++) {
+			auto entity = registry.create();
+			registry.emplace<sgw::components::transform2d>(entity, static_cast<float>(i % 1000), static_cast<float>(i / 1000));
+		}
+	}
+}
+
+SGW_BENCHMARK(ecs_view_each_transform2d_100k) {
+	entt::registry registry;
+	populate(registry);
+	const glm::vec2 offset{ 0.5f, 0.25f };
+	state.set_items_per_iteration(entity_count);
+
+	for ([[maybe_unused]] auto _ : state) {
+		registry.view<sgw::components::transform2d>().each([&](auto& transform) {
+			transform.add_position(offset);
+			transform.add_rotation(0.01f);
+		});
+		bench::clobber_memory();
+	}
+}
+
+SGW_BENCHMARK(particle_pool_update_200k) {
+	constexpr std::size_t particle_count = 200000;
+	sgw::particle_pool pool(particle_count);
+	pool.set_acceleration({ 0.F, 98.F });
+	pool.set_damping(0.1F);
+	state.set_items_per_iteration(particle_count);
+
+	// lifetimes are in seconds; refilling every step keeps the pool full while about 1% of it dies
+	// per step, and two simulated seconds up front spread the ages out before measuring
+	const sgw::particle_emitter_params params{ .spawn_radius = 16.F, .min_speed = 50.F, .max_speed = 150.F, .min_lifetime = 1.F, .max_lifetime = 2.F };
+	for (int step = 0; step < 120; step++) {
+		pool.emit(params, particle_count);
+		pool.update(1.F / 60.F);
+	}
+
+	for ([[maybe_unused]] auto _ : state) {
+		pool.emit(params, particle_count);
+		pool.update(1.F / 60.F);
+		bench::clobber_memory();
+	}
+}
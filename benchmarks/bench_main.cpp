@@ -0,0 +1,167 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <string_view>
+#include "bench.h"
+#include "bench_context.h"
+
+namespace bench {
+	namespace {
+		std::unique_ptr<context> g_context;
+
+		struct result {
+			std::string name;
+			std::size_t iterations = 0;
+			double median_ns = 0.0;
+			double min_ns = 0.0;
+			double max_ns = 0.0;
+			double items_per_second = 0.0;
+			std::string skipped;
+		};
+
+		result measure(const entry& e, double min_time_s, std::size_t repetitions) {
+			result r;
+			r.name = e.name;
+
+			std::size_t iterations = 1;
+			while (true) {
+				state s(iterations);
+				e.run(s);
+
+				if (!s.get_skip_reason().empty()) {
+					r.skipped = s.get_skip_reason();
+					return r;
+				}
+
+				auto elapsed_s = s.elapsed_ns() / 1e9;
+				if (elapsed_s >= min_time_s || iterations >= (std::size_t{ 1 } << 30U)) {
+					break;
+				}
+
+				auto scale = elapsed_s > 0.0 ? std::min(10.0, (min_time_s * 1.2) / elapsed_s) : 10.0;
+				iterations = std::max(iterations + 1, static_cast<std::size_t>(static_cast<double>(iterations) * scale));
+			}
+
+			std::vector<double> per_op;
+			std::size_t items = 1;
+			for (std::size_t i = 0; i < repetitions; i++) {
+				state s(iterations);
+				e.run(s);
+				per_op.push_back(s.elapsed_ns() / static_cast<double>(iterations));
+				items = s.get_items_per_iteration();
+			}
+
+			std::sort(per_op.begin(), per_op.end());
+			r.iterations = iterations;
+			r.median_ns = per_op[per_op.size() / 2];
+			r.min_ns = per_op.front();
+			r.max_ns = per_op.back();
+			r.items_per_second = r.median_ns > 0.0 ? static_cast<double>(items) * 1e9 / r.median_ns : 0.0;
+			return r;
+		}
+
+		void write_json(std::ostream& out, const std::vector<result>& results) {
+			out << std::fixed << std::setprecision(3);
+			out << "{\n  \"schema\": 1,\n  \"benchmarks\": [";
+
+			for (std::size_t i = 0; i < results.size(); i++) {
+				const auto& r = results[i];
+				out << (i == 0 ? "\n" : ",\n");
+				out << "    {\"name\": \"" << r.name << "\", ";
+
+				if (!r.skipped.empty()) {
+					out << "\"skipped\": \"" << r.skipped << "\"}";
+					continue;
+				}
+
+				out << "\"iterations\": " << r.iterations
+					<< ", \"ns_per_op\": " << r.median_ns
+					<< ", \"min_ns_per_op\": " << r.min_ns
+					<< ", \"max_ns_per_op\": " << r.max_ns
+					<< ", \"items_per_second\": " << r.items_per_second << "}";
+			}
+
+			out << "\n  ]\n}\n";
+		}
+	}
+
+	context& get_context() {
+		return *g_context;
+	}
+}
+
+int main(int argc, char** argv) {
+	std::string json_path;
+	std::string filter;
+	double min_time_s = 0.2;
+	std::size_t repetitions = 5;
+	std::string font_path;
+
+	for (int i = 1; i < argc; i++) {
+		std::string_view arg = argv[i];
+		auto value = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+
+		if (arg == "--json") {
+			json_path = value();
+		}
+		else if (arg == "--filter") {
+			filter = value();
+		}
+		else if (arg == "--min-time") {
+			min_time_s = std::atof(value().c_str());
+		}
+		else if (arg == "--repetitions") {
+			repetitions = std::max<std::size_t>(1, std::strtoul(value().c_str(), nullptr, 10));
+		}
+		else if (arg == "--font") {
+			font_path = value();
+		}
+		else {
+			std::cerr << "usage: " << argv[0] << " [--json file] [--filter text] [--min-time seconds] [--repetitions n] [--font file.ttf]\n";
+			return 1;
+		}
+	}
+
+	setenv("SDL_VIDEODRIVER", "dummy", 0);
+	setenv("SDL_RENDER_DRIVER", "software", 0);
+
+	try {
+		bench::g_context = std::make_unique<bench::context>();
+		bench::g_context->font_path = !font_path.empty() ? font_path : (std::getenv("SGW_BENCH_FONT") != nullptr ? std::getenv("SGW_BENCH_FONT") : "");
+
+		auto entries = bench::registry();
+		std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.name < b.name; });
+
+		std::vector<bench::result> results;
+		for (const auto& e : entries) {
+			if (!filter.empty() && e.name.find(filter) == std::string::npos) {
+				continue;
+			}
+
+			auto r = bench::measure(e, min_time_s, repetitions);
+			if (r.skipped.empty()) {
+				std::printf("%-40s %14.1f ns/op %16.0f items/s\n", r.name.c_str(), r.median_ns, r.items_per_second);
+			}
+			else {
+				std::printf("%-40s skipped: %s\n", r.name.c_str(), r.skipped.c_str());
+			}
+			results.push_back(std::move(r));
+		}
+
+		if (!json_path.empty()) {
+			std::ofstream out(json_path);
+			bench::write_json(out, results);
+		}
+
+		bench::g_context.reset();
+	}
+	catch (const std::exception& ex) {
+		std::cerr << ex.what() << '\n';
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,90 @@
+#include <vector>
+#include "bench.h"
+#include "bench_context.h"
+
+namespace {
+	constexpr std::size_t present_interval = 1024;
+
+	void maybe_present(const sdl::renderer& renderer, std::size_t& counter) {
+		if (++counter % present_interval == 0) {
+			renderer.present();
+		}
+	}
+
+	std::vector<SDL_FPoint> make_points(std::size_t amount) {
+		std::vector<SDL_FPoint> points(amount);
+		for (auto& p : points) {
+			p = { sgw::random::next(0.f, static_cast<float>(bench::context::window_w)), sgw::random::next(0.f, static_cast<float>(bench::context::window_h)) };
+		}
+		return points;
+	}
+}
+
+SGW_BENCHMARK(renderer_fill_rect) {
+	const auto& renderer = bench::get_context().renderer;
+	const SDL_Rect rect{ 10, 10, 32, 32 };
+	const SDL_Color color{ 255, 0, 0, 255 };
+	std::size_t counter = 0;
+
+	for ([[maybe_unused]] auto _ : state) {
+		renderer.fill_rect(rect, color);
+		maybe_present(renderer, counter);
+	}
+}
+
+SGW_BENCHMARK(renderer_fill_rect_alternating_color) {
+	const auto& renderer = bench::get_context().renderer;
+	const SDL_Rect rect{ 10, 10, 32, 32 };
+	const SDL_Color colors[2]{ { 255, 0, 0, 255 }, { 0, 0, 255, 255 } };
+	std::size_t counter = 0;
+
+	for ([[maybe_unused]] auto _ : state) {
+		renderer.fill_rect(rect, colors[counter & 1U]);
+		maybe_present(renderer, counter);
+	}
+}
+
+SGW_BENCHMARK(renderer_draw_points_f_1000) {
+	const auto& renderer = bench::get_context().renderer;
+	const auto points = make_points(1000);
+	std::size_t counter = 0;
+	state.set_items_per_iteration(points.size());
+
+	for ([[maybe_unused]] auto _ : state) {
+		renderer.draw_points_f(points.begin(), points.end(), SDL_Color{ 255, 255, 255, 255 });
+		maybe_present(renderer, counter);
+	}
+}
+
+SGW_BENCHMARK(renderer_copy_ex_f) {
+	const auto& renderer = bench::get_context().renderer;
+	auto texture = renderer.create_texture(SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, 32, 32);
+	const SDL_FPoint position{ 200.f, 200.f };
+	std::size_t counter = 0;
+
+	for ([[maybe_unused]] auto _ : state) {
+		renderer.copy_ex_f(texture, position, static_cast<double>(counter % 360));
+		maybe_present(renderer, counter);
+	}
+}
+
+SGW_BENCHMARK(sprite_batch_10k_8_textures) {
+	const auto& renderer = bench::get_context().renderer;
+	std::vector<sdl::texture> textures;
+	for (int i = 0; i < 8; i++) {
+		textures.push_back(renderer.create_texture(SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, 16, 16));
+	}
+
+	const auto points = make_points(10000);
+	sdl::sprite_batch batch(points.size());
+	state.set_items_per_iteration(points.size());
+
+	for ([[maybe_unused]] auto _ : state) {
+		batch.begin();
+		for (std::size_t i = 0; i < points.size(); i++) {
+			batch.submit_centered(textures[i % textures.size()], points[i]);
+		}
+		batch.flush(renderer);
+		renderer.present();
+	}
+}
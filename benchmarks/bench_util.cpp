@@ -0,0 +1,61 @@
+#include <random>
+#include <vector>
+#include "bench.h"
+#include "sgw.h"
+
+SGW_BENCHMARK(random_next_int) {
+	int value = 0;
+	for ([[maybe_unused]] auto _ : state) {
+		value += sgw::random::next(0, 1000);
+	}
+	bench::do_not_optimize(value);
+}
+
+SGW_BENCHMARK(random_next_float) {
+	float value = 0.f;
+	for ([[maybe_unused]] auto _ : state) {
+		value += sgw::random::next(0.f, 1.f);
+	}
+	bench::do_not_optimize(value);
+}
+
+SGW_BENCHMARK(random_next_float_mt19937) {
+	float value = 0.f;
+	for ([[maybe_unused]] auto _ : state) {
+		value += sgw::random::next<std::mt19937>(0.f, 1.f);
+	}
+	bench::do_not_optimize(value);
+}
+
+SGW_BENCHMARK(random_range_float_4096) {
+	std::vector<float> values(4096);
+	state.set_items_per_iteration(values.size());
+
+	for ([[maybe_unused]] auto _ : state) {
+		sgw::random::range(0.f, 1.f, values.size(), values.begin());
+		bench::clobber_memory();
+	}
+}
+
+SGW_BENCHMARK(math_intersection) {
+	const glm::vec2 p1{ 0.f, 10.f };
+	const glm::vec2 p2{ 10.f, -10.f };
+	glm::vec2 position{ -5.f, 0.f };
+	const glm::vec2 direction{ 1.f, 0.1f };
+
+	for ([[maybe_unused]] auto _ : state) {
+		auto hit = sgw::math::intersection(p1, p2, position, direction);
+		bench::do_not_optimize(hit);
+		bench::clobber_memory();
+	}
+}
+
+SGW_BENCHMARK(math_limit_length) {
+	glm::vec2 vector{ 30.f, 40.f };
+
+	for ([[maybe_unused]] auto _ : state) {
+		auto limited = sgw::math::limit_length(vector, 10.f);
+		bench::do_not_optimize(limited);
+		bench::clobber_memory();
+	}
+}
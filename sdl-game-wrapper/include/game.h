@@ -1,3 +1,13 @@
 #pragma once
 #include "game/game.h"
+#include "game/camera.h"
+#include "game/frame_pacer.h"
+#include "game/input.h"
+#include "game/input_recording.h"
+#include "game/parallel_sprite_batch.h"
+#include "game/particle_pool.h"
+#include "game/spatial_hash.h"
+#include "game/system_scheduler.h"
+#include "game/tilemap.h"
+#include "game/systems/kinematics.h"
 #include "game/components.h"
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+#include <cmath>
+#include <vector>
+#include <SDL.h>
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+
+#include "../sdl/renderer.h"
+#include "components/transform.h"
+#include "components/bounds.h"
+#include "spatial_hash.h"
+
+namespace sgw {
+
+	// maps world space to screen space; position is the world point shown at the viewport centre,
+	// rotation is in degrees like renderer::copy_ex
+	struct camera2d {
+
+		camera2d() = default;
+		camera2d(glm::vec2 viewport_size, glm::vec2 position = {}, float zoom = 1.F, float rotation = 0.F)
+			: m_position(position), m_viewport_size(viewport_size), m_zoom(zoom) {
+			set_rotation(rotation);
+		}
+
+		[[nodiscard]] const glm::vec2& get_position() const noexcept { return m_position; }
+		void set_position(const glm::vec2& position) noexcept { m_position = position; }
+		void move(const glm::vec2& offset) noexcept { m_position += offset; }
+
+		[[nodiscard]] float get_zoom() const noexcept { return m_zoom; }
+		void set_zoom(float zoom) noexcept { m_zoom = zoom; }
+
+		[[nodiscard]] float get_rotation() const noexcept { return m_rotation; }
+		void set_rotation(float rotation) noexcept {
+			m_rotation = rotation;
+			auto radians = glm::radians(rotation);
+			m_cos = std::cos(radians);
+			m_sin = std::sin(radians);
+		}
+
+		[[nodiscard]] const glm::vec2& get_viewport_size() const noexcept { return m_viewport_size; }
+		void set_viewport_size(const glm::vec2& size) noexcept { m_viewport_size = size; }
+
+		void fit_viewport(const sdl::renderer& renderer) {
+			auto extends = renderer.get_output_size_extends_f<glm::vec2>();
+			m_viewport_size = extends.right_lower - extends.left_upper;
+		}
+
+		[[nodiscard]] glm::vec2 world_to_screen(const glm::vec2& world) const noexcept {
+			auto offset = world - m_position;
+			glm::vec2 rotated{ offset.x * m_cos + offset.y * m_sin, -offset.x * m_sin + offset.y * m_cos };
+			return rotated * m_zoom + m_viewport_size * 0.5F;
+		}
+
+		[[nodiscard]] glm::vec2 screen_to_world(const glm::vec2& screen) const noexcept {
+			auto offset = (screen - m_viewport_size * 0.5F) / m_zoom;
+			glm::vec2 rotated{ offset.x * m_cos - offset.y * m_sin, offset.x * m_sin + offset.y * m_cos };
+			return rotated + m_position;
+		}
+
+		// axis aligned world rectangle containing everything the viewport can show
+		[[nodiscard]] std::pair<glm::vec2, glm::vec2> get_visible_aabb() const noexcept {
+			auto half = m_viewport_size * (0.5F / m_zoom);
+			auto abs_cos = std::abs(m_cos);
+			auto abs_sin = std::abs(m_sin);
+			glm::vec2 extent{ half.x * abs_cos + half.y * abs_sin, half.x * abs_sin + half.y * abs_cos };
+			return { m_position - extent, m_position + extent };
+		}
+
+		[[nodiscard]] bool is_visible(const glm::vec2& center, float radius) const noexcept {
+			auto screen = world_to_screen(center);
+			auto r = radius * m_zoom;
+			return screen.x + r >= 0.F && screen.y + r >= 0.F && screen.x - r <= m_viewport_size.x && screen.y - r <= m_viewport_size.y;
+		}
+
+		[[nodiscard]] bool is_visible(const components::transform2d& transform, const components::bounds2d& bounds) const noexcept {
+			return is_visible(transform.get_position(), bounds.get_radius());
+		}
+
+		// destination rect and angle for renderer::copy_ex_f / sprite_batch::submit
+		[[nodiscard]] SDL_FRect to_screen_rect(const glm::vec2& center, const glm::vec2& size) const noexcept {
+			auto screen = world_to_screen(center);
+			auto w = size.x * m_zoom;
+			auto h = size.y * m_zoom;
+			return { screen.x - w / 2.F, screen.y - h / 2.F, w, h };
+		}
+
+		[[nodiscard]] double to_screen_rotation(float rotation) const noexcept {
+			return static_cast<double>(rotation - m_rotation);
+		}
+
+	private:
+		glm::vec2 m_position{};
+		glm::vec2 m_viewport_size{};
+		float m_zoom = 1.F;
+		float m_rotation = 0.F;
+		float m_cos = 1.F;
+		float m_sin = 0.F;
+	};
+
+	namespace culling {
+
+		// entities with a transform and bounds that intersect the viewport
+		inline void collect_visible(const camera2d& camera, const entt::registry& registry, std::vector<entt::entity>& visible) {
+			registry.view<const components::transform2d, const components::bounds2d>().each([&](auto entity, const auto& transform, const auto& bounds) {
+				if (camera.is_visible(transform, bounds)) {
+					visible.push_back(entity);
+				}
+			});
+		}
+
+		// broadphase variant, max_radius has to cover the largest bounds in the index
+		inline void collect_visible(const camera2d& camera, const spatial_hash& index, const entt::registry& registry, float max_radius, std::vector<entt::entity>& visible) {
+			auto [min, max] = camera.get_visible_aabb();
+			index.for_each_in_aabb(min - max_radius, max + max_radius, [&](auto entity, const auto& position) {
+				const auto* bounds = registry.try_get<components::bounds2d>(entity);
+				if (camera.is_visible(position, bounds != nullptr ? bounds->get_radius() : 0.F)) {
+					visible.push_back(entity);
+				}
+			});
+		}
+	}
+}
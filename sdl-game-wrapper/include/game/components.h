@@ -1,2 +1,4 @@
 #pragma once
-#include "components/transform.h"
\ No newline at end of file
+#include "components/bounds.h"
+#include "components/transform.h"
+#include "components/velocity.h"
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+#include <glm/glm.hpp>
+
+namespace sgw::components {
+	// local extents around the transform position, used for culling and broadphase
+	struct bounds2d {
+
+		using vector_type = glm::vec<2, float, glm::packed_highp>;
+
+		constexpr bounds2d() = default;
+		explicit bounds2d(vector_type half_extents) : m_half_extents(half_extents), m_radius(glm::length(glm::vec2(half_extents))) {}
+		bounds2d(float width, float height) : bounds2d(vector_type(width / 2.F, height / 2.F)) {}
+
+		[[nodiscard]] constexpr const vector_type& get_half_extents() const noexcept {
+			return m_half_extents;
+		}
+
+		[[nodiscard]] constexpr vector_type get_size() const noexcept {
+			return { m_half_extents.x * 2.F, m_half_extents.y * 2.F };
+		}
+
+		// radius of the circle enclosing the bounds under any rotation
+		[[nodiscard]] constexpr float get_radius() const noexcept {
+			return m_radius;
+		}
+
+	private:
+		vector_type m_half_extents{};
+		float m_radius = 0.F;
+	};
+}
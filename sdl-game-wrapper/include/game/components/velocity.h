@@ -0,0 +1,53 @@
+#pragma once
+#include <glm/glm.hpp>
+
+namespace sgw::components {
+	template<typename T, std::size_t Axis>
+	struct generic_velocity {
+
+		using type = generic_velocity<T, Axis>;
+		using value_type = T;
+		using vector_type = glm::vec<Axis, T, glm::packed_highp>;
+
+		constexpr generic_velocity() = default;
+		explicit constexpr generic_velocity(vector_type linear) : m_linear(linear) {}
+		constexpr generic_velocity(value_type x, value_type y) : m_linear(x, y) {}
+		constexpr generic_velocity(value_type x, value_type y, value_type angular) : m_linear(x, y), m_angular(angular) {}
+		constexpr generic_velocity(vector_type linear, value_type angular) : m_linear(linear), m_angular(angular) {}
+		constexpr generic_velocity(generic_velocity&&) noexcept = default;
+		constexpr generic_velocity(const generic_velocity&) = default;
+		constexpr generic_velocity& operator=(const generic_velocity&) = default;
+		constexpr generic_velocity& operator=(generic_velocity&&) noexcept = default;
+		~generic_velocity() = default;
+
+		[[nodiscard]] constexpr const vector_type& get_linear() const noexcept {
+			return m_linear;
+		}
+
+		template <typename VectorType = vector_type>
+		constexpr void set_linear(const VectorType& linear) noexcept {
+			m_linear.x = linear.x;
+			m_linear.y = linear.y;
+		}
+
+		template <typename VectorType = vector_type>
+		constexpr void add_linear(const VectorType& linear) noexcept {
+			m_linear += linear;
+		}
+
+		[[nodiscard]] constexpr const value_type& get_angular() const noexcept {
+			return m_angular;
+		}
+
+		constexpr void set_angular(value_type angular) noexcept {
+			m_angular = angular;
+		}
+
+	private:
+		vector_type m_linear{};
+		value_type m_angular{};
+	};
+
+	// same memory layout as transform2d, which lets the kinematics kernel treat both as flat float arrays
+	using velocity2d = generic_velocity<float, 2>;
+}
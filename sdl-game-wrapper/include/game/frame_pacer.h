@@ -0,0 +1,165 @@
+#pragma once
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <algorithm>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <timeapi.h>
+#if defined(_MSC_VER)
+#pragma comment(lib, "winmm.lib")
+#endif
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
+namespace sgw {
+
+	enum class frame_pacing {
+		uncapped,
+		target_fps,
+		vsync
+	};
+
+	struct frame_pacer {
+		using clock = std::chrono::steady_clock;
+
+		static constexpr double default_target_fps = 60.0;
+		static constexpr std::chrono::microseconds sleep_quantum{ 1000 };
+		// weight of the newest oversleep sample, the estimate follows roughly the last 20 sleeps
+		static constexpr double sleep_estimate_weight = 0.05;
+
+		frame_pacer() = default;
+		frame_pacer(frame_pacing pacing, double target_fps) : m_pacing(pacing) {
+			set_target_fps(target_fps);
+		}
+
+		frame_pacer(const frame_pacer&) = delete;
+		frame_pacer(frame_pacer&&) = delete;
+		frame_pacer& operator=(const frame_pacer&) = delete;
+		frame_pacer& operator=(frame_pacer&&) = delete;
+
+		~frame_pacer() {
+#if defined(_WIN32)
+			if (m_timer != nullptr) {
+				CloseHandle(m_timer);
+			}
+			if (m_raised_resolution) {
+				timeEndPeriod(1);
+			}
+#endif
+		}
+
+		[[nodiscard]] frame_pacing get_pacing() const noexcept { return m_pacing; }
+		void set_pacing(frame_pacing pacing) noexcept {
+			m_pacing = pacing;
+			m_next_frame = clock::time_point{};
+		}
+
+		[[nodiscard]] double get_target_fps() const noexcept { return m_target_fps; }
+		void set_target_fps(double target_fps) noexcept {
+			m_target_fps = target_fps > 0.0 ? target_fps : default_target_fps;
+			m_frame_period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / m_target_fps));
+			m_next_frame = clock::time_point{};
+		}
+
+		void wait() {
+			if (m_pacing != frame_pacing::target_fps) {
+				return;
+			}
+
+			auto now = clock::now();
+			if (m_next_frame == clock::time_point{} || now - m_next_frame > m_frame_period) {
+				// first frame or too far behind: resynchronise instead of bursting to catch up
+				m_next_frame = now + m_frame_period;
+				return;
+			}
+
+			sleep_until(m_next_frame);
+			m_next_frame += m_frame_period;
+		}
+
+	private:
+		void sleep_until(clock::time_point deadline) {
+			auto now = clock::now();
+
+			// sleep in small quanta while the remaining time exceeds the expected oversleep
+			while (deadline - now > std::chrono::duration<double>(m_sleep_estimate)) {
+				auto start = now;
+				sleep_once();
+				now = clock::now();
+
+				update_sleep_estimate(std::chrono::duration<double>(now - start).count());
+			}
+
+			while (clock::now() < deadline) {
+				std::this_thread::yield();
+			}
+		}
+
+		// the plain sleep_for lasts a whole scheduler tick on windows, 15.6 ms unless something
+		// raised the timer resolution, so a high resolution waitable timer is used there instead
+		void sleep_once() {
+#if defined(_WIN32)
+			if (!m_timer_opened) {
+				open_timer();
+			}
+
+			if (m_timer != nullptr) {
+				LARGE_INTEGER due;
+				due.QuadPart = -static_cast<LONGLONG>(sleep_quantum.count() * 10);
+				if (SetWaitableTimerEx(m_timer, &due, 0, nullptr, nullptr, nullptr, 0) != 0) {
+					WaitForSingleObject(m_timer, INFINITE);
+					return;
+				}
+			}
+#endif
+			std::this_thread::sleep_for(sleep_quantum);
+		}
+
+#if defined(_WIN32)
+		void open_timer() {
+			m_timer_opened = true;
+			m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+			if (m_timer == nullptr) {
+				// high resolution timers need windows 10 1803, raise the resolution for the process instead
+				m_raised_resolution = timeBeginPeriod(1) == TIMERR_NOERROR;
+				m_timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+			}
+		}
+#endif
+
+		// exponentially weighted, so a few slow sleeps early on (or a changed timer resolution)
+		// stop mattering after a while
+		void update_sleep_estimate(double observed) {
+			const auto delta = observed - m_sleep_mean;
+			m_sleep_mean += sleep_estimate_weight * delta;
+			m_sleep_variance = (1.0 - sleep_estimate_weight) * (m_sleep_variance + sleep_estimate_weight * delta * delta);
+
+			m_sleep_estimate = m_sleep_mean + std::sqrt(m_sleep_variance);
+		}
+
+		frame_pacing m_pacing = frame_pacing::uncapped;
+		double m_target_fps = default_target_fps;
+		clock::duration m_frame_period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / default_target_fps));
+		clock::time_point m_next_frame{};
+
+		double m_sleep_estimate = 0.005;
+		double m_sleep_mean = 0.005;
+		double m_sleep_variance = 0.0;
+
+#if defined(_WIN32)
+		HANDLE m_timer = nullptr;
+		bool m_timer_opened = false;
+		bool m_raised_resolution = false;
+#endif
+	};
+}
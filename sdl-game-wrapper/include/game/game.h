@@ -6,6 +6,8 @@
 #include <memory>
 #include <algorithm>
 #include <chrono>
+#include <optional>
+#include <vector>
 #include <entt/entt.hpp>
 
 #include "../sdl/lib.h"
@@ -13,6 +15,16 @@
 #include "../sdl/renderer.h"
 #include "../sdl/font_manager.h"
 #include "../sdl/image_manager.h"
+#include "../sdl/asset_loader.h"
+#include "../sdl/layer_stack.h"
+#include "../sdl/texture_cache.h"
+#include "frame_pacer.h"
+#include "input.h"
+#include "input_recording.h"
+#include "system_scheduler.h"
+#include "../util/frame_arena.h"
+#include "../util/profiler.h"
+#include "../util/random.h"
 
 //#undef main
 
@@ -36,6 +48,21 @@ namespace sgw {
 		Uint32 window_flags;
 		Uint32 renderer_flags;
 		double game_time_step = default_time_step;
+		std::size_t asset_loader_threads = 0;
+		std::size_t worker_threads = 0;
+		std::size_t frame_arena_bytes = frame_arena::default_block_size;
+		std::chrono::microseconds asset_upload_budget = asset_loader::default_frame_budget;
+		std::size_t texture_budget_bytes = texture_cache::default_budget_bytes;
+		bool drop_uploaded_surfaces = false;
+		frame_pacing pacing = frame_pacing::uncapped;
+		double target_fps = frame_pacer::default_target_fps;
+		// seeds sgw::random before game_preload; a recording without one picks a seed and stores it
+		std::optional<std::uint64_t> random_seed;
+		// writes every polled event with its tick to this file
+		std::string_view record_input_path;
+		// plays a recorded log back instead of live input, with the seed and time step of the recording
+		std::string_view replay_input_path;
+		replay_mode replay = replay_mode::realtime;
 	};
 
 	struct game {
@@ -47,13 +74,26 @@ namespace sgw {
 		game& operator=(const game&) = delete;
 		~game() = default;
 
+		static constexpr std::size_t default_event_capacity = 128;
+
 		explicit game(game_parameters params)
 			: m_sdl_lib(params.sdl_lib_flags),
 			  m_image_manager(params.sdl_image_flags),
 			  m_window(params.initial_window_title.data(), params.window_x, params.window_y, params.window_w, params.window_h, params.window_flags),
-			  m_renderer(m_window, -1, params.renderer_flags),
+			  m_renderer(m_window, -1, renderer_flags(params)),
+			  m_asset_loader(params.asset_loader_threads),
+			  m_texture_cache(m_renderer, m_image_manager, params.texture_budget_bytes, params.drop_uploaded_surfaces),
+			  m_layers(m_renderer),
 			  m_mouse_position(0, 0),
-			  m_game_time_step(params.game_time_step) {
+			  m_thread_pool(params.worker_threads),
+			  m_systems(m_thread_pool),
+			  m_frame_arenas(m_thread_pool, params.frame_arena_bytes),
+			  m_game_time_step(params.game_time_step),
+			  m_asset_upload_budget(params.asset_upload_budget),
+			  m_frame_pacer(params.pacing, params.target_fps),
+			  m_replay_mode(params.replay) {
+			m_frame_events.reserve(default_event_capacity);
+			open_input_log(params);
 		}
 
 		[[nodiscard]] const sdl::lib& get_sdl_lib() const noexcept { return m_sdl_lib; }
@@ -64,16 +104,32 @@ namespace sgw {
 		[[nodiscard]] sgw::font_manager& get_font_manager() noexcept { return m_font_manager; }
 		[[nodiscard]] const sgw::image_manager& get_image_manager() const noexcept { return m_image_manager; }
 		[[nodiscard]] sgw::image_manager& get_image_manager() noexcept { return m_image_manager; }
+		[[nodiscard]] sgw::asset_loader& get_asset_loader() noexcept { return m_asset_loader; }
+		[[nodiscard]] sgw::texture_cache& get_texture_cache() noexcept { return m_texture_cache; }
+		[[nodiscard]] sgw::layer_stack& get_layers() noexcept { return m_layers; }
+		[[nodiscard]] sgw::frame_pacer& get_frame_pacer() noexcept { return m_frame_pacer; }
 
 		[[nodiscard]] float get_delta_time() const noexcept { return static_cast<float>(m_delta_time); }
 		[[nodiscard]] double get_delta_time_precise() const noexcept { return m_delta_time; }
+		// fixed steps run since start
+		[[nodiscard]] std::uint64_t get_tick() const noexcept { return m_tick; }
 		[[nodiscard]] std::pair<int, int> get_mouse_position() const noexcept { return m_mouse_position; }
+		[[nodiscard]] const sgw::input_state& get_input() const noexcept { return m_input; }
+		[[nodiscard]] const profiling::frame_stats& get_frame_stats() const noexcept { return m_frame_stats; }
+		[[nodiscard]] profiling::frame_stats& get_frame_stats() noexcept { return m_frame_stats; }
 
 		[[nodiscard]] const entt::registry& get_entity_registry() const noexcept { return m_entity_registry; }
 		[[nodiscard]] entt::registry& get_entity_registry() noexcept { return m_entity_registry; }
+		[[nodiscard]] sgw::thread_pool& get_thread_pool() noexcept { return m_thread_pool; }
+		[[nodiscard]] sgw::system_scheduler& get_systems() noexcept { return m_systems; }
+		// reset at the start of every frame, for the main thread only
+		[[nodiscard]] sgw::frame_arena& get_frame_arena() noexcept { return m_frame_arenas.main(); }
+		[[nodiscard]] sgw::frame_arenas& get_frame_arenas() noexcept { return m_frame_arenas; }
 
 		void signal_quit() noexcept;
 		[[nodiscard]] bool is_running() const noexcept { return m_should_run; }
+		[[nodiscard]] bool is_recording_input() const noexcept { return m_input_recorder.has_value(); }
+		[[nodiscard]] bool is_replaying_input() const noexcept { return m_input_replayer.has_value(); }
 
 		virtual void start();
 
@@ -83,20 +139,54 @@ namespace sgw {
 		sgw::image_manager m_image_manager;
 		sdl::window m_window;
 		sdl::renderer m_renderer;
+		sgw::asset_loader m_asset_loader;
+		sgw::texture_cache m_texture_cache;
+		sgw::layer_stack m_layers;
 
 		std::pair<int, int> m_mouse_position;
+		sgw::input_state m_input;
+		std::vector<SDL_Event> m_frame_events;
 
 		entt::registry m_entity_registry;
+		sgw::thread_pool m_thread_pool;
+		sgw::system_scheduler m_systems;
+		sgw::frame_arenas m_frame_arenas;
 		double m_game_time_step = game_parameters::default_time_step;
+		std::chrono::microseconds m_asset_upload_budget = asset_loader::default_frame_budget;
+		frame_pacer m_frame_pacer;
+		profiling::frame_stats m_frame_stats;
+
+		std::optional<input_recorder> m_input_recorder;
+		std::optional<input_replayer> m_input_replayer;
+		replay_mode m_replay_mode = replay_mode::realtime;
 
 		bool m_should_run = true;
 		double m_delta_time = 0.0;
+		std::uint64_t m_tick = 0;
 
 		virtual void game_logic() = 0;
 		virtual void game_draw(const sdl::renderer& renderer) = 0;
-		virtual void handle_event(SDL_Event event) = 0;
+		virtual void handle_event(SDL_Event /*event*/) {}
+		virtual void handle_events(const std::vector<SDL_Event>& events);
+
+		virtual void on_key_down(const SDL_KeyboardEvent& /*event*/) {}
+		virtual void on_key_up(const SDL_KeyboardEvent& /*event*/) {}
+		virtual void on_mouse_motion(const SDL_MouseMotionEvent& /*event*/) {}
+		virtual void on_mouse_button_down(const SDL_MouseButtonEvent& /*event*/) {}
+		virtual void on_mouse_button_up(const SDL_MouseButtonEvent& /*event*/) {}
+		virtual void on_mouse_wheel(const SDL_MouseWheelEvent& /*event*/) {}
+		virtual void on_text_input(const SDL_TextInputEvent& /*event*/) {}
+		virtual void on_window_event(const SDL_WindowEvent& /*event*/) {}
 		virtual void game_preload() = 0;
 
+		[[nodiscard]] static Uint32 renderer_flags(const game_parameters& params) noexcept {
+			return params.pacing == frame_pacing::vsync ? params.renderer_flags | SDL_RENDERER_PRESENTVSYNC : params.renderer_flags;
+		}
+
+		void open_input_log(const game_parameters& params);
+		void dispatch_events();
+		void replay_events();
+
 		virtual void logic();
 		virtual void draw();
 		virtual void poll_events();
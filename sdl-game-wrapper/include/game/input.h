@@ -0,0 +1,112 @@
+#pragma once
+#include <SDL.h>
+#include <bitset>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace sgw {
+
+	struct input_state {
+		static constexpr std::size_t max_mouse_buttons = 8;
+
+		// edges, deltas and text accumulate over every poll until a logic tick has seen them, so a
+		// press is neither lost in a frame without ticks nor repeated by a frame with several
+		void end_tick() noexcept {
+			m_keys_pressed.reset();
+			m_keys_released.reset();
+			m_buttons_pressed.reset();
+			m_buttons_released.reset();
+			m_mouse_delta = { 0, 0 };
+			m_wheel = { 0, 0 };
+			m_text_input.clear();
+		}
+
+		void process(const SDL_Event& event) {
+			switch (event.type) {
+			case SDL_KEYDOWN:
+				if (event.key.repeat == 0) {
+					set_key(event.key.keysym.scancode, true);
+				}
+				break;
+			case SDL_KEYUP:
+				set_key(event.key.keysym.scancode, false);
+				break;
+			case SDL_MOUSEMOTION:
+				m_mouse_position = { event.motion.x, event.motion.y };
+				m_mouse_delta.first += event.motion.xrel;
+				m_mouse_delta.second += event.motion.yrel;
+				break;
+			case SDL_MOUSEBUTTONDOWN:
+				m_mouse_position = { event.button.x, event.button.y };
+				set_button(event.button.button, true);
+				break;
+			case SDL_MOUSEBUTTONUP:
+				m_mouse_position = { event.button.x, event.button.y };
+				set_button(event.button.button, false);
+				break;
+			case SDL_MOUSEWHEEL:
+				m_wheel.first += event.wheel.x;
+				m_wheel.second += event.wheel.y;
+				break;
+			case SDL_TEXTINPUT:
+				m_text_input.append(event.text.text);
+				break;
+			default:
+				break;
+			}
+		}
+
+		[[nodiscard]] bool is_key_down(SDL_Scancode key) const noexcept { return test(m_keys_down, key); }
+		[[nodiscard]] bool was_key_pressed(SDL_Scancode key) const noexcept { return test(m_keys_pressed, key); }
+		[[nodiscard]] bool was_key_released(SDL_Scancode key) const noexcept { return test(m_keys_released, key); }
+
+		[[nodiscard]] bool is_mouse_button_down(Uint8 button) const noexcept { return test(m_buttons_down, button); }
+		[[nodiscard]] bool was_mouse_button_pressed(Uint8 button) const noexcept { return test(m_buttons_pressed, button); }
+		[[nodiscard]] bool was_mouse_button_released(Uint8 button) const noexcept { return test(m_buttons_released, button); }
+
+		[[nodiscard]] std::pair<int, int> get_mouse_position() const noexcept { return m_mouse_position; }
+		[[nodiscard]] std::pair<int, int> get_mouse_delta() const noexcept { return m_mouse_delta; }
+		[[nodiscard]] std::pair<int, int> get_mouse_wheel() const noexcept { return m_wheel; }
+		[[nodiscard]] std::string_view get_text_input() const noexcept { return m_text_input; }
+
+	private:
+		template <std::size_t N, typename Index>
+		[[nodiscard]] static bool test(const std::bitset<N>& bits, Index index) noexcept {
+			auto i = static_cast<std::size_t>(index);
+			return i < N && bits.test(i);
+		}
+
+		void set_key(SDL_Scancode key, bool down) noexcept {
+			auto i = static_cast<std::size_t>(key);
+			if (i >= m_keys_down.size()) {
+				return;
+			}
+
+			m_keys_down.set(i, down);
+			(down ? m_keys_pressed : m_keys_released).set(i);
+		}
+
+		void set_button(Uint8 button, bool down) noexcept {
+			if (button >= max_mouse_buttons) {
+				return;
+			}
+
+			m_buttons_down.set(button, down);
+			(down ? m_buttons_pressed : m_buttons_released).set(button);
+		}
+
+		std::bitset<SDL_NUM_SCANCODES> m_keys_down;
+		std::bitset<SDL_NUM_SCANCODES> m_keys_pressed;
+		std::bitset<SDL_NUM_SCANCODES> m_keys_released;
+
+		std::bitset<max_mouse_buttons> m_buttons_down;
+		std::bitset<max_mouse_buttons> m_buttons_pressed;
+		std::bitset<max_mouse_buttons> m_buttons_released;
+
+		std::pair<int, int> m_mouse_position{ 0, 0 };
+		std::pair<int, int> m_mouse_delta{ 0, 0 };
+		std::pair<int, int> m_wheel{ 0, 0 };
+		std::string m_text_input;
+	};
+}
@@ -0,0 +1,266 @@
+#pragma once
+#include <SDL.h>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../sdl/errors.h"
+
+namespace sgw {
+
+	// header, then one record per poll: the tick delta and event count as varints, followed by every
+	// event as a varint size and the leading bytes of the SDL_Event that its type actually uses. the
+	// session ends with a record without events at the tick the game stopped at
+	struct input_log_header {
+		static constexpr std::array<char, 4> expected_magic{ 'S', 'G', 'W', 'I' };
+		static constexpr std::uint32_t current_version = 2;
+
+		std::array<char, 4> magic;
+		std::uint32_t version;
+		std::uint64_t seed;
+		double time_step;
+	};
+
+	static_assert(sizeof(input_log_header) == 24);
+	static_assert(std::endian::native == std::endian::little, "input logs are stored little endian");
+
+	enum class replay_mode {
+		// ticks follow the wall clock and every frame is drawn, like a live session
+		realtime,
+		// ticks run back to back without frame pacing, frames are still drawn
+		fast,
+		// as fast, without drawing or presenting
+		headless
+	};
+
+	// events carrying pointers can not be replayed and are left out of the log
+	[[nodiscard]] inline bool is_recordable(const SDL_Event& event) noexcept {
+		switch (event.type) {
+		case SDL_SYSWMEVENT:
+		case SDL_DROPFILE:
+		case SDL_DROPTEXT:
+			return false;
+		default:
+			return event.type < SDL_USEREVENT;
+		}
+	}
+
+	[[nodiscard]] inline std::size_t recorded_size(const SDL_Event& event) noexcept {
+		switch (event.type) {
+		case SDL_QUIT: return sizeof(SDL_QuitEvent);
+		case SDL_WINDOWEVENT: return sizeof(SDL_WindowEvent);
+		case SDL_KEYDOWN:
+		case SDL_KEYUP: return sizeof(SDL_KeyboardEvent);
+		case SDL_TEXTEDITING: return sizeof(SDL_TextEditingEvent);
+		case SDL_TEXTINPUT: return sizeof(SDL_TextInputEvent);
+		case SDL_MOUSEMOTION: return sizeof(SDL_MouseMotionEvent);
+		case SDL_MOUSEBUTTONDOWN:
+		case SDL_MOUSEBUTTONUP: return sizeof(SDL_MouseButtonEvent);
+		case SDL_MOUSEWHEEL: return sizeof(SDL_MouseWheelEvent);
+		case SDL_RENDER_TARGETS_RESET:
+		case SDL_RENDER_DEVICE_RESET: return sizeof(SDL_CommonEvent);
+		default: return sizeof(SDL_Event);
+		}
+	}
+
+	// writes the events of every poll together with the number of fixed steps that ran before it
+	struct input_recorder {
+		input_recorder() = delete;
+		input_recorder(const std::string& path, std::uint64_t seed, double time_step) : m_path(path), m_file(path, std::ios::binary | std::ios::trunc) {
+			if (!m_file) {
+				throw sdl::input_log_error(path + ": could not open for writing");
+			}
+
+			input_log_header header{
+				.magic = input_log_header::expected_magic,
+				.version = input_log_header::current_version,
+				.seed = seed,
+				.time_step = time_step
+			};
+			m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		}
+
+		input_recorder(const input_recorder&) = delete;
+		input_recorder(input_recorder&&) = delete;
+		input_recorder& operator=(const input_recorder&) = delete;
+		input_recorder& operator=(input_recorder&&) = delete;
+		~input_recorder() {
+			finish(m_tick);
+		}
+
+		// input accumulates until a tick consumes it, so polls without events are left out
+		void record(std::uint64_t tick, const std::vector<SDL_Event>& events) {
+			m_tick = tick;
+			m_events.clear();
+			std::uint64_t count = 0;
+			for (const auto& event : events) {
+				if (!is_recordable(event)) {
+					continue;
+				}
+
+				auto size = recorded_size(event);
+				write_varint(m_events, size);
+				auto* bytes = reinterpret_cast<const char*>(&event);
+				m_events.insert(m_events.end(), bytes, bytes + size);
+				count++;
+			}
+
+			if (count == 0) {
+				return;
+			}
+
+			write_poll(tick, count);
+			m_file.write(m_events.data(), static_cast<std::streamsize>(m_events.size()));
+
+			if (!m_file) {
+				throw sdl::input_log_error(m_path + ": write failed");
+			}
+
+			m_polls++;
+		}
+
+		void flush() { m_file.flush(); }
+
+		// writes the end of session record, replay runs ticks up to this one. nothing is recorded
+		// afterwards; the destructor finishes at the tick of the last poll if this was not called
+		void finish(std::uint64_t tick) {
+			if (m_finished) {
+				return;
+			}
+
+			m_finished = true;
+			write_poll(tick, 0);
+			m_file.flush();
+		}
+
+		[[nodiscard]] std::size_t get_poll_count() const noexcept { return m_polls; }
+
+	private:
+		void write_poll(std::uint64_t tick, std::uint64_t count) {
+			m_poll.clear();
+			write_varint(m_poll, tick - m_last_tick);
+			write_varint(m_poll, count);
+			m_file.write(m_poll.data(), static_cast<std::streamsize>(m_poll.size()));
+			m_last_tick = tick;
+		}
+
+		static void write_varint(std::vector<char>& output, std::uint64_t value) {
+			while (value >= 0x80) {
+				output.push_back(static_cast<char>((value & 0x7F) | 0x80));
+				value >>= 7;
+			}
+			output.push_back(static_cast<char>(value));
+		}
+
+		std::string m_path;
+		std::ofstream m_file;
+		std::vector<char> m_poll;
+		std::vector<char> m_events;
+		std::uint64_t m_last_tick = 0;
+		std::uint64_t m_tick = 0;
+		std::size_t m_polls = 0;
+		bool m_finished = false;
+	};
+
+	// reads a log written by input_recorder. the whole file is loaded up front so replaying never
+	// waits on the disk
+	struct input_replayer {
+		input_replayer() = delete;
+		explicit input_replayer(const std::string& path) : m_path(path) {
+			std::ifstream file(path, std::ios::binary);
+			if (!file) {
+				throw sdl::input_log_error(path + ": could not open input log");
+			}
+
+			m_data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+			if (m_data.size() < sizeof(m_header)) {
+				throw sdl::input_log_error(path + ": not an input log");
+			}
+
+			std::memcpy(&m_header, m_data.data(), sizeof(m_header));
+			if (m_header.magic != input_log_header::expected_magic || m_header.version != input_log_header::current_version) {
+				throw sdl::input_log_error(path + ": not an input log or unsupported version");
+			}
+
+			m_offset = sizeof(m_header);
+			read_next_tick();
+		}
+
+		input_replayer(const input_replayer&) = delete;
+		input_replayer(input_replayer&&) = delete;
+		input_replayer& operator=(const input_replayer&) = delete;
+		input_replayer& operator=(input_replayer&&) = delete;
+		~input_replayer() = default;
+
+		[[nodiscard]] std::uint64_t get_seed() const noexcept { return m_header.seed; }
+		[[nodiscard]] double get_time_step() const noexcept { return m_header.time_step; }
+
+		[[nodiscard]] bool is_finished() const noexcept { return !m_has_next; }
+		// tick the next poll was recorded at, only valid while not finished
+		[[nodiscard]] std::uint64_t get_next_tick() const noexcept { return m_next_tick; }
+		[[nodiscard]] bool is_due(std::uint64_t tick) const noexcept { return m_has_next && m_next_tick <= tick; }
+		// tick the session was stopped at, only valid once finished. a log cut short without an end
+		// record stops at its last poll
+		[[nodiscard]] std::uint64_t get_end_tick() const noexcept { return m_next_tick; }
+
+		// replaces the contents of events with the next recorded poll
+		void read(std::vector<SDL_Event>& events) {
+			events.clear();
+
+			for (std::uint64_t i = 0; i < m_next_count; i++) {
+				auto size = read_varint();
+				if (size > sizeof(SDL_Event) || size > m_data.size() - m_offset) {
+					throw sdl::input_log_error(m_path + ": corrupt event");
+				}
+
+				SDL_Event event{};
+				std::memcpy(&event, m_data.data() + m_offset, size);
+				m_offset += size;
+				events.push_back(event);
+			}
+
+			read_next_tick();
+		}
+
+	private:
+		void read_next_tick() {
+			m_has_next = m_offset < m_data.size();
+			if (m_has_next) {
+				m_next_tick += read_varint();
+				m_next_count = read_varint();
+				m_has_next = m_next_count != 0;
+			}
+		}
+
+		std::uint64_t read_varint() {
+			std::uint64_t value = 0;
+			for (int shift = 0; shift < 64; shift += 7) {
+				if (m_offset >= m_data.size()) {
+					break;
+				}
+
+				auto byte = static_cast<std::uint8_t>(m_data[m_offset++]);
+				value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0) {
+					return value;
+				}
+			}
+
+			throw sdl::input_log_error(m_path + ": truncated");
+		}
+
+		std::string m_path;
+		std::vector<char> m_data;
+		input_log_header m_header{};
+		std::size_t m_offset = 0;
+		std::uint64_t m_next_tick = 0;
+		std::uint64_t m_next_count = 0;
+		bool m_has_next = false;
+	};
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include <entt/entt.hpp>
+
+#include "../sdl/renderer.h"
+#include "../sdl/sprite_batch.h"
+#include "../util/thread_pool.h"
+
+namespace sgw {
+
+	// sprite batches that pool workers record into concurrently; flush merges them on the main
+	// thread and replays the result through one sprite_batch. only recording may happen off the
+	// main thread, textures are not touched until flush
+	struct parallel_sprite_batch {
+		static constexpr std::size_t default_chunk_size = 1024;
+
+		explicit parallel_sprite_batch(thread_pool& pool) : m_pool(pool), m_thread_batches(pool.size() + 1) {}
+
+		parallel_sprite_batch(const parallel_sprite_batch&) = delete;
+		parallel_sprite_batch(parallel_sprite_batch&&) = delete;
+		parallel_sprite_batch& operator=(const parallel_sprite_batch&) = delete;
+		parallel_sprite_batch& operator=(parallel_sprite_batch&&) = delete;
+		~parallel_sprite_batch() = default;
+
+		void begin() {
+			for (auto& batch : m_thread_batches) {
+				batch.begin();
+			}
+			for (auto& batch : m_chunk_batches) {
+				batch.begin();
+			}
+			m_merged.begin();
+			m_chunks_used = 0;
+		}
+
+		// the calling thread's batch, for pool workers and the thread owning the pool. which worker
+		// records what varies between frames, so sprites with equal sort keys need distinct depths
+		[[nodiscard]] sdl::sprite_batch& local() noexcept {
+			return m_thread_batches[m_pool.current_worker()];
+		}
+
+		// records a component view in chunks across the pool. every chunk gets its own batch and the
+		// chunks are merged in view order, so ties replay in the same order whichever thread ran them
+		template <typename Component, typename Func>
+		void record_each(entt::registry& registry, Func func, std::size_t chunk_size = default_chunk_size) {
+			chunk_size = std::max<std::size_t>(1, chunk_size);
+
+			auto view = registry.view<Component>();
+			auto* entities = view.data();
+			auto* components = view.raw();
+			auto count = view.size();
+
+			auto first = m_chunks_used;
+			m_chunks_used += (count + chunk_size - 1) / chunk_size;
+			if (m_chunk_batches.size() < m_chunks_used) {
+				m_chunk_batches.resize(m_chunks_used);
+			}
+
+			m_pool.parallel_for(count, chunk_size, [&](std::size_t begin, std::size_t end) {
+				auto& batch = m_chunk_batches[first + begin / chunk_size];
+				for (auto i = begin; i < end; i++) {
+					func(batch, entities[i], components[i]);
+				}
+				batch.sort();
+			});
+		}
+
+		void flush(const sdl::renderer& renderer) {
+			m_pool.parallel_for(m_thread_batches.size(), 1, [this](std::size_t begin, std::size_t end) {
+				for (auto i = begin; i < end; i++) {
+					m_thread_batches[i].sort();
+				}
+			});
+
+			m_sources.clear();
+			for (std::size_t i = 0; i < m_chunks_used; i++) {
+				m_sources.push_back(&m_chunk_batches[i]);
+			}
+			for (auto& batch : m_thread_batches) {
+				m_sources.push_back(&batch);
+			}
+
+			m_merged.merge_sorted(m_sources);
+			m_merged.flush(renderer);
+			m_chunks_used = 0;
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept {
+			auto total = m_merged.size();
+			for (const auto& batch : m_thread_batches) {
+				total += batch.size();
+			}
+			for (std::size_t i = 0; i < m_chunks_used; i++) {
+				total += m_chunk_batches[i].size();
+			}
+			return total;
+		}
+
+		// stats of the merged batch, valid after flush
+		[[nodiscard]] const sdl::sprite_batch_stats& get_stats() const noexcept { return m_merged.get_stats(); }
+
+	private:
+		thread_pool& m_pool;
+		std::vector<sdl::sprite_batch> m_thread_batches;
+		std::vector<sdl::sprite_batch> m_chunk_batches;
+		std::size_t m_chunks_used = 0;
+		std::vector<sdl::sprite_batch*> m_sources;
+		sdl::sprite_batch m_merged;
+	};
+}
@@ -0,0 +1,298 @@
+#pragma once
+#include <SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "../sdl/renderer.h"
+#include "../sdl/sprite_batch.h"
+#include "../sdl/texture.h"
+#include "../util/random.h"
+#include "../util/simd.h"
+#include "camera.h"
+
+namespace sgw {
+
+	struct particle_emitter_params {
+		glm::vec2 position{};
+		float spawn_radius = 0.F;
+		float direction = 0.F;
+		float spread = 360.F;
+		float min_speed = 0.F;
+		float max_speed = 100.F;
+		float min_lifetime = 1.F;
+		float max_lifetime = 1.F;
+	};
+
+	// fixed capacity particles stored as structure of arrays. colour follows a gradient over
+	// each particle's life, quantized into buckets so drawing needs one call per bucket
+	struct particle_pool {
+		static constexpr std::size_t default_capacity = 65536;
+		static constexpr std::size_t default_color_buckets = 16;
+
+		explicit particle_pool(std::size_t capacity = default_capacity, SDL_Color start_color = { 255, 255, 255, 255 }, SDL_Color end_color = { 255, 255, 255, 0 }, std::size_t color_buckets = default_color_buckets)
+			: m_capacity(capacity) {
+			for (auto* values : { &m_x, &m_y, &m_vx, &m_vy, &m_age, &m_inverse_lifetime }) {
+				values->resize(capacity);
+			}
+			m_bucket.resize(capacity);
+			m_points.resize(capacity);
+
+			set_gradient(start_color, end_color, color_buckets);
+		}
+
+		particle_pool(const particle_pool&) = delete;
+		particle_pool(particle_pool&&) noexcept = default;
+		particle_pool& operator=(const particle_pool&) = delete;
+		particle_pool& operator=(particle_pool&&) noexcept = default;
+		~particle_pool() = default;
+
+		void set_gradient(SDL_Color start_color, SDL_Color end_color, std::size_t color_buckets = default_color_buckets) {
+			color_buckets = std::max<std::size_t>(1, color_buckets);
+			m_colors.resize(color_buckets);
+			m_bucket_offsets.resize(color_buckets + 1);
+
+			auto lerp = [](Uint8 a, Uint8 b, float t) {
+				return static_cast<Uint8>(std::lround(static_cast<float>(a) + (static_cast<float>(b) - static_cast<float>(a)) * t));
+			};
+
+			for (std::size_t i = 0; i < color_buckets; i++) {
+				auto t = color_buckets > 1 ? static_cast<float>(i) / static_cast<float>(color_buckets - 1) : 0.F;
+				m_colors[i] = { lerp(start_color.r, end_color.r, t), lerp(start_color.g, end_color.g, t), lerp(start_color.b, end_color.b, t), lerp(start_color.a, end_color.a, t) };
+			}
+
+			// live particles were bucketed for the old count, drawing indexes m_colors with them
+			const auto bucket_count = static_cast<float>(color_buckets);
+			const auto last_bucket = static_cast<float>(color_buckets - 1);
+			for (std::size_t i = 0; i < m_count; i++) {
+				m_bucket[i] = static_cast<std::int32_t>(std::min(m_age[i] * m_inverse_lifetime[i] * bucket_count, last_bucket));
+			}
+		}
+
+		void set_acceleration(const glm::vec2& acceleration) noexcept { m_acceleration = acceleration; }
+		[[nodiscard]] const glm::vec2& get_acceleration() const noexcept { return m_acceleration; }
+
+		// fraction of velocity lost per second
+		void set_damping(float damping) noexcept { m_damping = damping; }
+		[[nodiscard]] float get_damping() const noexcept { return m_damping; }
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_count; }
+		[[nodiscard]] std::size_t capacity() const noexcept { return m_capacity; }
+		[[nodiscard]] bool empty() const noexcept { return m_count == 0; }
+
+		void clear() noexcept { m_count = 0; }
+
+		// spawns up to count particles, fewer when the pool is full; returns how many were spawned
+		std::size_t emit(const particle_emitter_params& params, std::size_t count) {
+			count = std::min(count, m_capacity - m_count);
+			if (count == 0) {
+				return 0;
+			}
+
+			auto& generator = random::thread_generator();
+			const auto first = m_count;
+
+			// bulk fill the raw samples straight into the destination arrays, then shape them in place
+			generator.range(0.F, 1.F, count, m_x.data() + first);
+			generator.range(0.F, 1.F, count, m_y.data() + first);
+			generator.range(params.direction - params.spread / 2.F, params.direction + params.spread / 2.F, count, m_vx.data() + first);
+			generator.range(params.min_speed, params.max_speed, count, m_vy.data() + first);
+			generator.range(params.min_lifetime, params.max_lifetime, count, m_inverse_lifetime.data() + first);
+
+			constexpr float two_pi = 6.28318530717958647692F;
+			for (auto i = first; i < first + count; i++) {
+				auto radius = params.spawn_radius * std::sqrt(m_x[i]);
+				auto spawn_angle = two_pi * m_y[i];
+				auto angle = glm::radians(m_vx[i]);
+				auto speed = m_vy[i];
+
+				m_x[i] = params.position.x + radius * std::cos(spawn_angle);
+				m_y[i] = params.position.y + radius * std::sin(spawn_angle);
+				m_vx[i] = speed * std::cos(angle);
+				m_vy[i] = speed * std::sin(angle);
+				m_age[i] = 0.F;
+				m_inverse_lifetime[i] = 1.F / std::max(m_inverse_lifetime[i], 0.0001F);
+				m_bucket[i] = 0;
+			}
+
+			m_count += count;
+			return count;
+		}
+
+		void update(float delta_time) {
+			if (m_count == 0) {
+				return;
+			}
+
+			const auto ax = m_acceleration.x * delta_time;
+			const auto ay = m_acceleration.y * delta_time;
+			const auto damping = std::max(0.F, 1.F - m_damping * delta_time);
+			// every bucket covers an equal share of the life; a particle reaching the end is removed
+			// below, so the last bucket has to start before it
+			const auto bucket_count = static_cast<float>(m_colors.size());
+			const auto last_bucket = static_cast<float>(m_colors.size() - 1);
+
+			auto* x = m_x.data();
+			auto* y = m_y.data();
+			auto* vx = m_vx.data();
+			auto* vy = m_vy.data();
+			auto* age = m_age.data();
+			const auto* inverse_lifetime = m_inverse_lifetime.data();
+			auto* bucket = m_bucket.data();
+
+			bool any_dead = false;
+			std::size_t i = 0;
+
+#if defined(SGW_SIMD_SSE2)
+			const auto dt4 = _mm_set1_ps(delta_time);
+			const auto ax4 = _mm_set1_ps(ax);
+			const auto ay4 = _mm_set1_ps(ay);
+			const auto damping4 = _mm_set1_ps(damping);
+			const auto one4 = _mm_set1_ps(1.F);
+			const auto bucket_count4 = _mm_set1_ps(bucket_count);
+			const auto last_bucket4 = _mm_set1_ps(last_bucket);
+			auto dead4 = _mm_setzero_ps();
+
+			for (; i + 4 <= m_count; i += 4) {
+				auto px = _mm_loadu_ps(x + i);
+				auto py = _mm_loadu_ps(y + i);
+				auto pvx = _mm_loadu_ps(vx + i);
+				auto pvy = _mm_loadu_ps(vy + i);
+				auto page = _mm_add_ps(_mm_loadu_ps(age + i), dt4);
+
+				_mm_storeu_ps(x + i, _mm_add_ps(px, _mm_mul_ps(pvx, dt4)));
+				_mm_storeu_ps(y + i, _mm_add_ps(py, _mm_mul_ps(pvy, dt4)));
+				_mm_storeu_ps(vx + i, _mm_mul_ps(_mm_add_ps(pvx, ax4), damping4));
+				_mm_storeu_ps(vy + i, _mm_mul_ps(_mm_add_ps(pvy, ay4), damping4));
+				_mm_storeu_ps(age + i, page);
+
+				auto life = _mm_mul_ps(page, _mm_loadu_ps(inverse_lifetime + i));
+				dead4 = _mm_or_ps(dead4, _mm_cmpge_ps(life, one4));
+				auto index = _mm_cvttps_epi32(_mm_min_ps(_mm_mul_ps(life, bucket_count4), last_bucket4));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(bucket + i), index);
+			}
+
+			any_dead = _mm_movemask_ps(dead4) != 0;
+#endif
+
+			for (; i < m_count; i++) {
+				x[i] += vx[i] * delta_time;
+				y[i] += vy[i] * delta_time;
+				vx[i] = (vx[i] + ax) * damping;
+				vy[i] = (vy[i] + ay) * damping;
+				age[i] += delta_time;
+
+				auto life = age[i] * inverse_lifetime[i];
+				any_dead = any_dead || life >= 1.F;
+				bucket[i] = static_cast<std::int32_t>(std::min(life * bucket_count, last_bucket));
+			}
+
+			if (any_dead) {
+				remove_dead();
+			}
+		}
+
+		[[nodiscard]] std::size_t get_bucket_count() const noexcept { return m_colors.size(); }
+		[[nodiscard]] const SDL_Color& get_bucket_color(std::size_t bucket) const { return m_colors[bucket]; }
+
+		// one draw_points_f call per non-empty colour bucket
+		void draw_points(const sdl::renderer& renderer) {
+			sort_points([](float x, float y) { return SDL_FPoint{ x, y }; });
+			draw_sorted_points(renderer);
+		}
+
+		void draw_points(const sdl::renderer& renderer, const camera2d& camera) {
+			sort_points([&camera](float x, float y) {
+				auto screen = camera.world_to_screen({ x, y });
+				return SDL_FPoint{ screen.x, screen.y };
+			});
+			draw_sorted_points(renderer);
+		}
+
+		// textured quads centered on each particle, tinted with the bucket colour
+		void submit(sdl::sprite_batch& batch, const sdl::texture& texture, const glm::vec2& size, sdl::sprite_params params = {}) const {
+			for (std::size_t i = 0; i < m_count; i++) {
+				params.color = m_colors[static_cast<std::size_t>(m_bucket[i])];
+				batch.submit(texture, SDL_FRect{ m_x[i] - size.x / 2.F, m_y[i] - size.y / 2.F, size.x, size.y }, params);
+			}
+		}
+
+		void submit(sdl::sprite_batch& batch, const sdl::texture& texture, const glm::vec2& size, const camera2d& camera, sdl::sprite_params params = {}) const {
+			params.rotation = camera.to_screen_rotation(static_cast<float>(params.rotation));
+			for (std::size_t i = 0; i < m_count; i++) {
+				params.color = m_colors[static_cast<std::size_t>(m_bucket[i])];
+				batch.submit(texture, camera.to_screen_rect({ m_x[i], m_y[i] }, size), params);
+			}
+		}
+
+	private:
+		// swap-remove, order is not preserved
+		void remove_dead() {
+			std::size_t i = 0;
+			while (i < m_count) {
+				if (m_age[i] * m_inverse_lifetime[i] < 1.F) {
+					i++;
+					continue;
+				}
+
+				auto last = --m_count;
+				m_x[i] = m_x[last];
+				m_y[i] = m_y[last];
+				m_vx[i] = m_vx[last];
+				m_vy[i] = m_vy[last];
+				m_age[i] = m_age[last];
+				m_inverse_lifetime[i] = m_inverse_lifetime[last];
+				m_bucket[i] = m_bucket[last];
+			}
+		}
+
+		// counting sort of the particle positions by colour bucket into m_points
+		template <typename Project>
+		void sort_points(Project project) {
+			std::fill(m_bucket_offsets.begin(), m_bucket_offsets.end(), 0U);
+			for (std::size_t i = 0; i < m_count; i++) {
+				m_bucket_offsets[static_cast<std::size_t>(m_bucket[i]) + 1]++;
+			}
+
+			for (std::size_t b = 1; b < m_bucket_offsets.size(); b++) {
+				m_bucket_offsets[b] += m_bucket_offsets[b - 1];
+			}
+
+			m_cursor.assign(m_bucket_offsets.begin(), m_bucket_offsets.end() - 1);
+			for (std::size_t i = 0; i < m_count; i++) {
+				m_points[m_cursor[static_cast<std::size_t>(m_bucket[i])]++] = project(m_x[i], m_y[i]);
+			}
+		}
+
+		void draw_sorted_points(const sdl::renderer& renderer) const {
+			for (std::size_t b = 0; b + 1 < m_bucket_offsets.size(); b++) {
+				auto begin = m_bucket_offsets[b];
+				auto amount = m_bucket_offsets[b + 1] - begin;
+				if (amount != 0) {
+					renderer.draw_points_f(m_points.begin() + begin, static_cast<int>(amount), m_colors[b]);
+				}
+			}
+		}
+
+		std::size_t m_capacity;
+		std::size_t m_count = 0;
+
+		std::vector<float> m_x;
+		std::vector<float> m_y;
+		std::vector<float> m_vx;
+		std::vector<float> m_vy;
+		std::vector<float> m_age;
+		std::vector<float> m_inverse_lifetime;
+		std::vector<std::int32_t> m_bucket;
+
+		glm::vec2 m_acceleration{};
+		float m_damping = 0.F;
+
+		std::vector<SDL_Color> m_colors;
+		std::vector<std::uint32_t> m_bucket_offsets;
+		std::vector<std::uint32_t> m_cursor;
+		std::vector<SDL_FPoint> m_points;
+	};
+}
@@ -0,0 +1,395 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+
+#include "components/transform.h"
+
+namespace sgw {
+
+	struct spatial_hash {
+		using cell_key = std::uint64_t;
+
+		static constexpr float default_cell_size = 64.F;
+
+		explicit spatial_hash(float cell_size = default_cell_size)
+			: m_cell_size(cell_size), m_inverse_cell_size(1.F / cell_size) {}
+
+		// not movable, the registry's destroy signal holds on to this
+		spatial_hash(const spatial_hash&) = delete;
+		spatial_hash(spatial_hash&&) = delete;
+		spatial_hash& operator=(const spatial_hash&) = delete;
+		spatial_hash& operator=(spatial_hash&&) = delete;
+
+		~spatial_hash() {
+			disconnect();
+		}
+
+		[[nodiscard]] float get_cell_size() const noexcept { return m_cell_size; }
+		[[nodiscard]] std::size_t size() const noexcept { return m_entries.size(); }
+		[[nodiscard]] bool contains(entt::entity entity) const { return m_entries.find(entity) != m_entries.end(); }
+
+		void update(entt::entity entity, const glm::vec2& position) {
+			auto key = key_of(position);
+			auto [it, inserted] = m_entries.try_emplace(entity);
+			auto& current = it->second;
+
+			if (!inserted && current.cell == key) {
+				current.position = position;
+				m_cells[key][current.slot].position = position;
+				return;
+			}
+
+			if (!inserted) {
+				erase_from_cell(current);
+			}
+
+			auto& cell = m_cells[key];
+			current.position = position;
+			current.cell = key;
+			current.slot = static_cast<std::uint32_t>(cell.size());
+			cell.push_back({ entity, position });
+		}
+
+		void remove(entt::entity entity) {
+			auto it = m_entries.find(entity);
+			if (it == m_entries.end()) {
+				return;
+			}
+
+			erase_from_cell(it->second);
+			m_entries.erase(it);
+		}
+
+		void clear() noexcept {
+			m_entries.clear();
+			m_cells.clear();
+		}
+
+		// starts tracking the registry: every entity with a transform is indexed, and from then on
+		// sync() only touches entities whose transform was assigned, replaced or destroyed through
+		// the registry, plus those passed to mark_dirty. a connected index therefore needs transforms
+		// written with registry.replace or registry.patch; add_position on a reference goes unseen.
+		// kinematics reports the moves it integrates when it is given the index
+		void connect(entt::registry& registry) {
+			disconnect();
+
+			m_registry = &registry;
+			m_observer = std::make_unique<entt::observer>(registry, entt::collector.group<components::transform2d>().replace<components::transform2d>());
+			registry.on_destroy<components::transform2d>().connect<&spatial_hash::on_transform_destroyed>(*this);
+			rebuild(registry);
+		}
+
+		void disconnect() {
+			if (m_registry == nullptr) {
+				return;
+			}
+
+			m_registry->on_destroy<components::transform2d>().disconnect<&spatial_hash::on_transform_destroyed>(*this);
+			m_observer.reset();
+			m_registry = nullptr;
+			m_dirty.clear();
+			m_stale.clear();
+		}
+
+		// for a transform written in place, which the registry doesn't see. main thread only
+		void mark_dirty(entt::entity entity) {
+			m_dirty.push_back(entity);
+		}
+
+		// applies the changes collected since the last sync, costs nothing when nothing moved
+		void sync() {
+			if (m_registry == nullptr) {
+				return;
+			}
+
+			for (auto entity : m_stale) {
+				remove(entity);
+			}
+			m_stale.clear();
+
+			for (auto entity : *m_observer) {
+				refresh(entity);
+			}
+			m_observer->clear();
+
+			for (auto entity : m_dirty) {
+				refresh(entity);
+			}
+			m_dirty.clear();
+		}
+
+		// re-buckets entities moved in place by a bulk pass, transforms[i] belonging to entities[i].
+		// only entities whose position changed are touched
+		void update_moved(const entt::entity* entities, const components::transform2d* transforms, std::size_t count) {
+			for (std::size_t i = 0; i < count; i++) {
+				glm::vec2 position = transforms[i].get_position();
+				auto it = m_entries.find(entities[i]);
+				if (it == m_entries.end() || it->second.position != position) {
+					update(entities[i], position);
+				}
+			}
+		}
+
+		// full pass over the registry, for indexes that are not connected or after moving most
+		// entities in place; entities that were destroyed or lost their transform are dropped
+		void rebuild(const entt::registry& registry) {
+			m_stale.clear();
+			for (const auto& [entity, current] : m_entries) {
+				if (!registry.valid(entity) || !registry.has<components::transform2d>(entity)) {
+					m_stale.push_back(entity);
+				}
+			}
+
+			for (auto entity : m_stale) {
+				remove(entity);
+			}
+			m_stale.clear();
+
+			registry.view<const components::transform2d>().each([this](auto entity, const auto& transform) {
+				glm::vec2 position = transform.get_position();
+				auto it = m_entries.find(entity);
+				if (it == m_entries.end() || it->second.position != position) {
+					update(entity, position);
+				}
+			});
+		}
+
+		// drops cells that no longer hold any entity
+		void prune() {
+			for (auto it = m_cells.begin(); it != m_cells.end();) {
+				it = it->second.empty() ? m_cells.erase(it) : std::next(it);
+			}
+		}
+
+		template <typename Func>
+		void for_each_in_aabb(const glm::vec2& min, const glm::vec2& max, Func func) const {
+			auto min_x = cell_coordinate(min.x);
+			auto min_y = cell_coordinate(min.y);
+			auto max_x = cell_coordinate(max.x);
+			auto max_y = cell_coordinate(max.y);
+
+			for (auto y = min_y; y <= max_y; y++) {
+				for (auto x = min_x; x <= max_x; x++) {
+					auto it = m_cells.find(make_key(x, y));
+					if (it == m_cells.end()) {
+						continue;
+					}
+
+					for (const auto& item : it->second) {
+						if (item.position.x >= min.x && item.position.x <= max.x && item.position.y >= min.y && item.position.y <= max.y) {
+							func(item.entity, item.position);
+						}
+					}
+				}
+			}
+		}
+
+		void query_aabb(const glm::vec2& min, const glm::vec2& max, std::vector<entt::entity>& result) const {
+			for_each_in_aabb(min, max, [&result](auto entity, const auto&) { result.push_back(entity); });
+		}
+
+		void query_radius(const glm::vec2& center, float radius, std::vector<entt::entity>& result) const {
+			const auto radius_squared = radius * radius;
+			for_each_in_aabb(center - radius, center + radius, [&](auto entity, const auto& position) {
+				auto offset = position - center;
+				if (glm::dot(offset, offset) <= radius_squared) {
+					result.push_back(entity);
+				}
+			});
+		}
+
+		// walks the cells crossed by the ray front to back (amanatides-woo); func(entity, position)
+		// decides what counts as a hit and returns false to stop the walk
+		template <typename Func>
+		void for_each_on_ray(const glm::vec2& origin, const glm::vec2& direction, float max_distance, Func func) const {
+			walk_ray(origin, direction, max_distance, [&](int x, int y) { return visit_cell(x, y, func); });
+		}
+
+		// entities within `thickness` of the segment, in the order the ray reaches their cells
+		void query_ray(const glm::vec2& origin, const glm::vec2& direction, float max_distance, float thickness, std::vector<entt::entity>& result) const {
+			auto length = glm::length(direction);
+			if (length == 0.F) {
+				return;
+			}
+
+			const auto dir = direction / length;
+			const auto thickness_squared = thickness * thickness;
+
+			auto test = [&](auto entity, const auto& position) {
+				auto offset = position - origin;
+				auto along = glm::clamp(glm::dot(offset, dir), 0.F, max_distance);
+				auto closest = offset - dir * along;
+				if (glm::dot(closest, closest) <= thickness_squared) {
+					result.push_back(entity);
+				}
+				return true;
+			};
+
+			if (thickness <= 0.F) {
+				for_each_on_ray(origin, dir, max_distance, test);
+			}
+			else if (thickness <= m_cell_size) {
+				// a hit lies at most one cell away from a crossed cell; the walk is monotonic, so a
+				// neighbour can only have been scanned by one of the last four crossed cells
+				std::array<std::pair<int, int>, 4> history{};
+				std::size_t walked = 0;
+
+				walk_ray(origin, dir, max_distance, [&](int x, int y) {
+					for (int ny = y - 1; ny <= y + 1; ny++) {
+						for (int nx = x - 1; nx <= x + 1; nx++) {
+							auto seen = std::any_of(history.begin(), history.begin() + std::min(walked, history.size()), [&](const auto& cell) {
+								return std::abs(cell.first - nx) <= 1 && std::abs(cell.second - ny) <= 1;
+							});
+
+							if (!seen) {
+								visit_cell(nx, ny, test);
+							}
+						}
+					}
+
+					history[walked++ % history.size()] = { x, y };
+					return true;
+				});
+			}
+			else {
+				auto end = origin + dir * max_distance;
+				for_each_in_aabb(glm::min(origin, end) - thickness, glm::max(origin, end) + thickness, test);
+			}
+		}
+
+	private:
+		struct item {
+			entt::entity entity;
+			glm::vec2 position;
+		};
+
+		struct entry {
+			glm::vec2 position{};
+			cell_key cell = 0;
+			std::uint32_t slot = 0;
+		};
+
+		// on_destroy fires before the transform is gone, so removal waits for the next sync
+		void on_transform_destroyed(entt::registry& /*registry*/, entt::entity entity) {
+			m_stale.push_back(entity);
+		}
+
+		void refresh(entt::entity entity) {
+			const auto* transform = m_registry->valid(entity) ? m_registry->try_get<components::transform2d>(entity) : nullptr;
+			if (transform != nullptr) {
+				update(entity, transform->get_position());
+			}
+			else {
+				remove(entity);
+			}
+		}
+
+		[[nodiscard]] int cell_coordinate(float value) const noexcept {
+			return static_cast<int>(std::floor(value * m_inverse_cell_size));
+		}
+
+		[[nodiscard]] static constexpr cell_key make_key(int x, int y) noexcept {
+			return (static_cast<cell_key>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+		}
+
+		[[nodiscard]] cell_key key_of(const glm::vec2& position) const noexcept {
+			return make_key(cell_coordinate(position.x), cell_coordinate(position.y));
+		}
+
+		template <typename Func>
+		bool visit_cell(int x, int y, Func& func) const {
+			auto it = m_cells.find(make_key(x, y));
+			if (it == m_cells.end()) {
+				return true;
+			}
+
+			for (const auto& item : it->second) {
+				if (!func(item.entity, item.position)) {
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		// calls visit(x, y) for every cell the ray crosses until it returns false or max_distance is reached
+		template <typename Visit>
+		void walk_ray(const glm::vec2& origin, const glm::vec2& direction, float max_distance, Visit visit) const {
+			auto length = glm::length(direction);
+			if (length == 0.F) {
+				return;
+			}
+
+			const auto dir = direction / length;
+			auto x = cell_coordinate(origin.x);
+			auto y = cell_coordinate(origin.y);
+			const int step_x = dir.x > 0 ? 1 : -1;
+			const int step_y = dir.y > 0 ? 1 : -1;
+
+			constexpr auto infinity = std::numeric_limits<float>::infinity();
+			const auto delta_x = dir.x != 0.F ? std::abs(m_cell_size / dir.x) : infinity;
+			const auto delta_y = dir.y != 0.F ? std::abs(m_cell_size / dir.y) : infinity;
+
+			auto boundary_x = static_cast<float>(step_x > 0 ? x + 1 : x) * m_cell_size;
+			auto boundary_y = static_cast<float>(step_y > 0 ? y + 1 : y) * m_cell_size;
+			auto next_x = dir.x != 0.F ? (boundary_x - origin.x) / dir.x : infinity;
+			auto next_y = dir.y != 0.F ? (boundary_y - origin.y) / dir.y : infinity;
+
+			auto travelled = 0.F;
+			while (travelled <= max_distance) {
+				if (!visit(x, y)) {
+					return;
+				}
+
+				if (next_x < next_y) {
+					travelled = next_x;
+					next_x += delta_x;
+					x += step_x;
+				}
+				else {
+					travelled = next_y;
+					next_y += delta_y;
+					y += step_y;
+				}
+			}
+		}
+
+		// swap-remove, patching the slot of the item moved into the hole
+		void erase_from_cell(const entry& current) {
+			auto& cell = m_cells[current.cell];
+			if (current.slot + 1 != cell.size()) {
+				cell[current.slot] = cell.back();
+				m_entries[cell[current.slot].entity].slot = current.slot;
+			}
+			cell.pop_back();
+		}
+
+		struct key_hash {
+			std::size_t operator()(cell_key key) const noexcept {
+				key ^= key >> 33;
+				key *= 0xFF51AFD7ED558CCDULL;
+				key ^= key >> 33;
+				return static_cast<std::size_t>(key);
+			}
+		};
+
+		float m_cell_size;
+		float m_inverse_cell_size;
+		std::unordered_map<cell_key, std::vector<item>, key_hash> m_cells;
+		std::unordered_map<entt::entity, entry> m_entries;
+		std::vector<entt::entity> m_stale;
+
+		entt::registry* m_registry = nullptr;
+		std::unique_ptr<entt::observer> m_observer;
+		std::vector<entt::entity> m_dirty;
+	};
+}
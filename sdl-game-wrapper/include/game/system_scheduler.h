@@ -0,0 +1,174 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <vector>
+#include <entt/entt.hpp>
+
+#include "../util/thread_pool.h"
+#include "../util/profiler.h"
+
+namespace sgw {
+
+	template <typename... Components>
+	struct reads {};
+
+	template <typename... Components>
+	struct writes {};
+
+	struct system_scheduler {
+		using system_id = std::size_t;
+		using system_function = std::function<void(entt::registry&, double)>;
+
+		static constexpr std::size_t default_chunk_size = 1024;
+
+		explicit system_scheduler(thread_pool& pool) : m_pool(pool) {}
+
+		system_scheduler(const system_scheduler&) = delete;
+		system_scheduler(system_scheduler&&) = delete;
+		system_scheduler& operator=(const system_scheduler&) = delete;
+		system_scheduler& operator=(system_scheduler&&) = delete;
+		~system_scheduler() = default;
+
+		// systems are ordered by registration; two systems only run concurrently when
+		// neither writes a component the other one touches
+		template <typename... Read, typename... Write>
+		system_id add_system(std::string name, reads<Read...>, writes<Write...>, system_function function) {
+			auto& added = m_systems.emplace_back();
+			added.name = std::move(name);
+			added.function = std::move(function);
+			added.reads = { std::type_index(typeid(std::remove_const_t<Read>))... };
+			added.writes = { std::type_index(typeid(std::remove_const_t<Write>))... };
+			added.prepare = [](entt::registry& registry) {
+				((void)registry.template view<std::remove_const_t<Read>>(), ...);
+				((void)registry.template view<std::remove_const_t<Write>>(), ...);
+			};
+
+			m_graph_dirty = true;
+			return m_systems.size() - 1;
+		}
+
+		void set_enabled(system_id id, bool enabled) noexcept { m_systems[id].enabled = enabled; }
+		[[nodiscard]] bool is_enabled(system_id id) const noexcept { return m_systems[id].enabled; }
+		[[nodiscard]] std::size_t size() const noexcept { return m_systems.size(); }
+		[[nodiscard]] thread_pool& get_thread_pool() const noexcept { return m_pool; }
+
+		void run(entt::registry& registry, double delta_time) {
+			if (m_systems.empty()) {
+				return;
+			}
+
+			if (m_graph_dirty) {
+				build_graph();
+			}
+
+			// component pools are created lazily by entt, which is not safe to do from several threads
+			for (auto& system : m_systems) {
+				system.prepare(registry);
+				system.remaining.store(system.dependencies, std::memory_order_relaxed);
+			}
+
+			task_group group;
+			for (system_id id = 0; id < m_systems.size(); id++) {
+				if (m_systems[id].dependencies == 0) {
+					schedule(group, id, registry, delta_time);
+				}
+			}
+
+			m_pool.wait(group);
+		}
+
+		// splits a single component view into chunks spread across the pool
+		template <typename Component, typename Func>
+		static void parallel_each(thread_pool& pool, entt::registry& registry, Func func, std::size_t chunk_size = default_chunk_size) {
+			auto view = registry.view<Component>();
+			auto* entities = view.data();
+			auto* components = view.raw();
+
+			pool.parallel_for(view.size(), chunk_size, [&](std::size_t begin, std::size_t end) {
+				for (auto i = begin; i < end; i++) {
+					func(entities[i], components[i]);
+				}
+			});
+		}
+
+	private:
+		struct system {
+			std::string name;
+			system_function function;
+			std::function<void(entt::registry&)> prepare;
+			std::vector<std::type_index> reads;
+			std::vector<std::type_index> writes;
+			std::vector<system_id> dependents;
+			std::size_t dependencies = 0;
+			std::atomic<std::size_t> remaining{ 0 };
+			bool enabled = true;
+
+			system() = default;
+			system(system&& other) noexcept
+				: name(std::move(other.name)),
+				  function(std::move(other.function)),
+				  prepare(std::move(other.prepare)),
+				  reads(std::move(other.reads)),
+				  writes(std::move(other.writes)),
+				  dependents(std::move(other.dependents)),
+				  dependencies(other.dependencies),
+				  enabled(other.enabled) {}
+		};
+
+		static bool overlaps(const std::vector<std::type_index>& a, const std::vector<std::type_index>& b) {
+			return std::any_of(a.begin(), a.end(), [&b](const auto& type) {
+				return std::find(b.begin(), b.end(), type) != b.end();
+			});
+		}
+
+		static bool conflicts(const system& first, const system& second) {
+			return overlaps(first.writes, second.writes)
+				|| overlaps(first.writes, second.reads)
+				|| overlaps(first.reads, second.writes);
+		}
+
+		void build_graph() {
+			for (auto& system : m_systems) {
+				system.dependents.clear();
+				system.dependencies = 0;
+			}
+
+			for (system_id later = 0; later < m_systems.size(); later++) {
+				for (system_id earlier = 0; earlier < later; earlier++) {
+					if (conflicts(m_systems[earlier], m_systems[later])) {
+						m_systems[earlier].dependents.push_back(later);
+						m_systems[later].dependencies++;
+					}
+				}
+			}
+
+			m_graph_dirty = false;
+		}
+
+		void schedule(task_group& group, system_id id, entt::registry& registry, double delta_time) {
+			m_pool.submit(group, [this, &group, id, &registry, delta_time]() {
+				auto& current = m_systems[id];
+				if (current.enabled) {
+					profiling::scoped_zone zone(current.name.c_str());
+					current.function(registry, delta_time);
+				}
+
+				for (auto dependent : current.dependents) {
+					if (m_systems[dependent].remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+						schedule(group, dependent, registry, delta_time);
+					}
+				}
+			});
+		}
+
+		thread_pool& m_pool;
+		std::vector<system> m_systems;
+		bool m_graph_dirty = false;
+	};
+}
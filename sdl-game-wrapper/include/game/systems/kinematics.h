@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+#include <entt/entt.hpp>
+
+#include "../../util/simd.h"
+#include "../components/transform.h"
+#include "../components/velocity.h"
+#include "../spatial_hash.h"
+#include "../system_scheduler.h"
+
+namespace sgw::kinematics {
+
+	static_assert(std::is_standard_layout_v<components::transform2d> && sizeof(components::transform2d) == 3 * sizeof(float));
+	static_assert(std::is_standard_layout_v<components::velocity2d> && sizeof(components::velocity2d) == 3 * sizeof(float));
+
+	inline constexpr std::size_t default_chunk_size = 4096;
+
+	// values[i] += rates[i] * delta_time
+	inline void integrate(float* values, const float* rates, std::size_t count, float delta_time) noexcept {
+		std::size_t i = 0;
+
+#if defined(SGW_SIMD_AVX)
+		const auto step = _mm256_set1_ps(delta_time);
+		for (; i + 8 <= count; i += 8) {
+			auto value = _mm256_loadu_ps(values + i);
+			auto rate = _mm256_loadu_ps(rates + i);
+			_mm256_storeu_ps(values + i, _mm256_add_ps(value, _mm256_mul_ps(rate, step)));
+		}
+#elif defined(SGW_SIMD_SSE2)
+		const auto step = _mm_set1_ps(delta_time);
+		for (; i + 4 <= count; i += 4) {
+			auto value = _mm_loadu_ps(values + i);
+			auto rate = _mm_loadu_ps(rates + i);
+			_mm_storeu_ps(values + i, _mm_add_ps(value, _mm_mul_ps(rate, step)));
+		}
+#endif
+
+		for (; i < count; i++) {
+			values[i] += rates[i] * delta_time;
+		}
+	}
+
+	// x, y and rotation line up with the linear and angular velocity, so one pass covers all three
+	inline void integrate(components::transform2d* transforms, const components::velocity2d* velocities, std::size_t count, float delta_time) noexcept {
+		integrate(reinterpret_cast<float*>(transforms), reinterpret_cast<const float*>(velocities), count * 3, delta_time);
+	}
+
+	// the group owns both pools so that the two raw arrays are sorted in the same order;
+	// components owned by it cannot be owned by another group
+	[[nodiscard]] inline auto get_group(entt::registry& registry) {
+		return registry.group<components::transform2d, components::velocity2d>();
+	}
+
+	inline void integrate(entt::registry& registry, float delta_time) {
+		auto group = get_group(registry);
+		integrate(group.raw<components::transform2d>(), group.raw<components::velocity2d>(), group.size(), delta_time);
+	}
+
+	inline void integrate(thread_pool& pool, entt::registry& registry, float delta_time, std::size_t chunk_size = default_chunk_size) {
+		auto group = get_group(registry);
+		auto* transforms = group.raw<components::transform2d>();
+		auto* velocities = group.raw<components::velocity2d>();
+
+		pool.parallel_for(group.size(), chunk_size, [=](std::size_t begin, std::size_t end) {
+			integrate(transforms + begin, velocities + begin, end - begin, delta_time);
+		});
+	}
+
+	// the transforms are written through raw pointers, which a connected spatial_hash doesn't see,
+	// so the moved entities are re-bucketed once integration has finished
+	inline void integrate(entt::registry& registry, float delta_time, spatial_hash& index) {
+		integrate(registry, delta_time);
+
+		auto group = get_group(registry);
+		index.update_moved(group.data(), group.raw<components::transform2d>(), group.size());
+	}
+
+	inline void integrate(thread_pool& pool, entt::registry& registry, float delta_time, spatial_hash& index, std::size_t chunk_size = default_chunk_size) {
+		integrate(pool, registry, delta_time, chunk_size);
+
+		auto group = get_group(registry);
+		index.update_moved(group.data(), group.raw<components::transform2d>(), group.size());
+	}
+
+	// creates the group up front, groups are not safe to construct from worker threads.
+	// with an index the system also keeps it up to date; it writes transform2d, so no system that
+	// reads transforms (and with them the index) runs at the same time
+	inline system_scheduler::system_id add_system(system_scheduler& scheduler, entt::registry& registry, spatial_hash* index = nullptr) {
+		(void)get_group(registry);
+
+		return scheduler.add_system("kinematics",
+			reads<components::velocity2d>{},
+			writes<components::transform2d>{},
+			[&pool = scheduler.get_thread_pool(), index](entt::registry& registry, double delta_time) {
+				if (index != nullptr) {
+					integrate(pool, registry, static_cast<float>(delta_time), *index);
+				}
+				else {
+					integrate(pool, registry, static_cast<float>(delta_time));
+				}
+			});
+	}
+}
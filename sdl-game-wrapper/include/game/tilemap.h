@@ -0,0 +1,294 @@
+#pragma once
+#include <SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "../sdl/renderer.h"
+#include "../sdl/texture.h"
+#include "camera.h"
+
+namespace sgw {
+
+	using tile_index = std::uint16_t;
+
+	// tile indices stored in square chunks. every chunk with tiles in it is baked into its own
+	// target texture the first time it becomes visible or after an edit, so drawing costs one
+	// copy per visible chunk. tile 0 is empty, tile n uses the n-1th cell of the tileset
+	struct tilemap {
+		static constexpr tile_index empty_tile = 0;
+		static constexpr int default_chunk_size = 32;
+		static constexpr std::size_t default_max_baked_chunks = 64;
+
+		tilemap(int width, int height, int tile_size, int chunk_size = default_chunk_size)
+			: m_width(width), m_height(height), m_tile_size(tile_size), m_chunk_size(chunk_size) {
+			if (width <= 0 || height <= 0 || tile_size <= 0 || chunk_size <= 0) {
+				throw std::invalid_argument("tilemap dimensions have to be positive");
+			}
+
+			m_chunks_x = (width + chunk_size - 1) / chunk_size;
+			m_chunks_y = (height + chunk_size - 1) / chunk_size;
+			m_chunks.resize(static_cast<std::size_t>(m_chunks_x) * static_cast<std::size_t>(m_chunks_y));
+		}
+
+		tilemap(const tilemap&) = delete;
+		tilemap(tilemap&&) noexcept = default;
+		tilemap& operator=(const tilemap&) = delete;
+		tilemap& operator=(tilemap&&) noexcept = default;
+		~tilemap() = default;
+
+		[[nodiscard]] int get_width() const noexcept { return m_width; }
+		[[nodiscard]] int get_height() const noexcept { return m_height; }
+		[[nodiscard]] int get_tile_size() const noexcept { return m_tile_size; }
+		[[nodiscard]] int get_chunk_size() const noexcept { return m_chunk_size; }
+
+		// world position of the top left corner of tile 0, 0
+		[[nodiscard]] const glm::vec2& get_origin() const noexcept { return m_origin; }
+		void set_origin(const glm::vec2& origin) noexcept { m_origin = origin; }
+
+		// the tileset is not owned and has to outlive the map, or be replaced before it is destroyed
+		void set_tileset(const sdl::texture& tileset) {
+			auto [w, h] = tileset.get_size();
+			m_tileset = &tileset;
+			m_tileset_columns = std::max(1, w / m_tile_size);
+			invalidate();
+		}
+
+		[[nodiscard]] bool contains(int x, int y) const noexcept {
+			return x >= 0 && y >= 0 && x < m_width && y < m_height;
+		}
+
+		[[nodiscard]] tile_index get_tile(int x, int y) const {
+			const auto& current = m_chunks[chunk_of(x, y)];
+			if (current.tiles.empty()) {
+				return empty_tile;
+			}
+
+			return current.tiles[tile_of(x, y)];
+		}
+
+		void set_tile(int x, int y, tile_index tile) {
+			auto& current = m_chunks[chunk_of(x, y)];
+			if (current.tiles.empty()) {
+				if (tile == empty_tile) {
+					return;
+				}
+
+				current.tiles.resize(static_cast<std::size_t>(m_chunk_size) * static_cast<std::size_t>(m_chunk_size), empty_tile);
+			}
+
+			auto& value = current.tiles[tile_of(x, y)];
+			if (value == tile) {
+				return;
+			}
+
+			current.filled += (tile != empty_tile) - (value != empty_tile);
+			value = tile;
+			current.dirty = true;
+
+			if (current.filled == 0) {
+				current.tiles = {};
+				release(current);
+			}
+		}
+
+		void fill(int x, int y, int w, int h, tile_index tile) {
+			auto x_end = std::min(x + w, m_width);
+			auto y_end = std::min(y + h, m_height);
+
+			for (auto ty = std::max(y, 0); ty < y_end; ty++) {
+				for (auto tx = std::max(x, 0); tx < x_end; tx++) {
+					set_tile(tx, ty, tile);
+				}
+			}
+		}
+
+		void clear() {
+			for (auto& current : m_chunks) {
+				current.tiles = {};
+				current.filled = 0;
+				release(current);
+			}
+		}
+
+		// forces every chunk to be baked again, e.g. after SDL_RENDER_TARGETS_RESET
+		void invalidate() noexcept {
+			for (auto& current : m_chunks) {
+				release(current);
+			}
+		}
+
+		// baked textures beyond this are freed least recently drawn first
+		void set_max_baked_chunks(std::size_t max_baked) noexcept { m_max_baked = max_baked; }
+		[[nodiscard]] std::size_t get_baked_chunk_count() const noexcept { return m_baked; }
+		[[nodiscard]] std::size_t get_bake_count() const noexcept { return m_bakes; }
+
+		// draws the chunks overlapping the renderer output, with world space equal to screen space
+		void draw(const sdl::renderer& renderer) {
+			camera2d camera;
+			camera.fit_viewport(renderer);
+			camera.set_position(camera.get_viewport_size() * 0.5F);
+			draw(renderer, camera);
+		}
+
+		void draw(const sdl::renderer& renderer, const camera2d& camera) {
+			if (m_tileset == nullptr) {
+				return;
+			}
+
+			m_frame++;
+
+			auto chunk_world_size = static_cast<float>(m_chunk_size * m_tile_size);
+			auto [min, max] = camera.get_visible_aabb();
+			auto first_x = std::max(0, static_cast<int>(std::floor((min.x - m_origin.x) / chunk_world_size)));
+			auto first_y = std::max(0, static_cast<int>(std::floor((min.y - m_origin.y) / chunk_world_size)));
+			auto last_x = std::min(m_chunks_x - 1, static_cast<int>(std::floor((max.x - m_origin.x) / chunk_world_size)));
+			auto last_y = std::min(m_chunks_y - 1, static_cast<int>(std::floor((max.y - m_origin.y) / chunk_world_size)));
+
+			if (first_x > last_x || first_y > last_y) {
+				return;
+			}
+
+			// bake before drawing so the render target only switches back once
+			std::optional<sdl::guard_render_target> restore_target;
+			for (auto cy = first_y; cy <= last_y; cy++) {
+				for (auto cx = first_x; cx <= last_x; cx++) {
+					auto& current = m_chunks[static_cast<std::size_t>(cy) * static_cast<std::size_t>(m_chunks_x) + static_cast<std::size_t>(cx)];
+					if (current.filled != 0 && (current.dirty || !current.baked)) {
+						bake(renderer, current, cx, cy, restore_target);
+					}
+				}
+			}
+			restore_target.reset();
+
+			glm::vec2 size{ chunk_world_size, chunk_world_size };
+			auto rotation = camera.to_screen_rotation(0.F);
+
+			for (auto cy = first_y; cy <= last_y; cy++) {
+				for (auto cx = first_x; cx <= last_x; cx++) {
+					auto& current = m_chunks[static_cast<std::size_t>(cy) * static_cast<std::size_t>(m_chunks_x) + static_cast<std::size_t>(cx)];
+					if (!current.baked) {
+						continue;
+					}
+
+					auto center = m_origin + glm::vec2{ static_cast<float>(cx) + 0.5F, static_cast<float>(cy) + 0.5F } * chunk_world_size;
+					if (rotation == 0.0) {
+						renderer.copy_f(*current.baked, camera.to_screen_rect(center, size));
+					}
+					else {
+						renderer.copy_ex_f(*current.baked, camera.to_screen_rect(center, size), rotation);
+					}
+					current.last_drawn_frame = m_frame;
+				}
+			}
+
+			trim();
+		}
+
+	private:
+		struct chunk {
+			std::vector<tile_index> tiles;
+			std::optional<sdl::texture> baked;
+			std::uint64_t last_drawn_frame = 0;
+			int filled = 0;
+			bool dirty = true;
+		};
+
+		[[nodiscard]] std::size_t chunk_of(int x, int y) const {
+			if (!contains(x, y)) {
+				throw std::out_of_range("tile outside of the tilemap");
+			}
+
+			return static_cast<std::size_t>(y / m_chunk_size) * static_cast<std::size_t>(m_chunks_x) + static_cast<std::size_t>(x / m_chunk_size);
+		}
+
+		[[nodiscard]] std::size_t tile_of(int x, int y) const noexcept {
+			return static_cast<std::size_t>(y % m_chunk_size) * static_cast<std::size_t>(m_chunk_size) + static_cast<std::size_t>(x % m_chunk_size);
+		}
+
+		void release(chunk& current) noexcept {
+			if (current.baked) {
+				current.baked.reset();
+				m_baked--;
+			}
+			current.dirty = true;
+		}
+
+		void bake(const sdl::renderer& renderer, chunk& current, int chunk_x, int chunk_y, std::optional<sdl::guard_render_target>& restore_target) {
+			if (!current.baked) {
+				auto pixels = m_chunk_size * m_tile_size;
+				current.baked = renderer.create_texture(SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, pixels, pixels);
+				// falls back to plain blending where custom modes are unsupported, see layer_params
+				current.baked->set_blend_mode_or_blend(sdl::premultiplied_blend_mode());
+				m_baked++;
+			}
+
+			if (restore_target) {
+				renderer.set_render_target(*current.baked);
+			}
+			else {
+				restore_target.emplace(renderer.push_render_target(*current.baked));
+			}
+			renderer.clear(SDL_Color{ 0, 0, 0, 0 });
+
+			auto columns = std::min(m_chunk_size, m_width - chunk_x * m_chunk_size);
+			auto rows = std::min(m_chunk_size, m_height - chunk_y * m_chunk_size);
+
+			for (auto y = 0; y < rows; y++) {
+				for (auto x = 0; x < columns; x++) {
+					auto tile = current.tiles[static_cast<std::size_t>(y) * static_cast<std::size_t>(m_chunk_size) + static_cast<std::size_t>(x)];
+					if (tile == empty_tile) {
+						continue;
+					}
+
+					auto cell = static_cast<int>(tile) - 1;
+					SDL_Rect source{ (cell % m_tileset_columns) * m_tile_size, (cell / m_tileset_columns) * m_tile_size, m_tile_size, m_tile_size };
+					SDL_Rect destination{ x * m_tile_size, y * m_tile_size, m_tile_size, m_tile_size };
+					renderer.copy(*m_tileset, destination, source);
+				}
+			}
+
+			current.dirty = false;
+			m_bakes++;
+		}
+
+		// frees the least recently drawn baked chunks that were not drawn this frame
+		void trim() {
+			while (m_baked > m_max_baked) {
+				chunk* oldest = nullptr;
+				for (auto& current : m_chunks) {
+					if (current.baked && current.last_drawn_frame != m_frame && (oldest == nullptr || current.last_drawn_frame < oldest->last_drawn_frame)) {
+						oldest = &current;
+					}
+				}
+
+				if (oldest == nullptr) {
+					return;
+				}
+
+				release(*oldest);
+			}
+		}
+
+		int m_width;
+		int m_height;
+		int m_tile_size;
+		int m_chunk_size;
+		int m_chunks_x = 0;
+		int m_chunks_y = 0;
+		glm::vec2 m_origin{};
+
+		std::vector<chunk> m_chunks;
+		const sdl::texture* m_tileset = nullptr;
+		int m_tileset_columns = 1;
+
+		std::size_t m_max_baked = default_max_baked_chunks;
+		std::size_t m_baked = 0;
+		std::size_t m_bakes = 0;
+		std::uint64_t m_frame = 0;
+	};
+}
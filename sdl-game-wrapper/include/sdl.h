@@ -1,13 +1,24 @@
 #pragma once
+#include "sdl/asset_loader.h"
+#include "sdl/asset_pack.h"
 #include "sdl/conversions.h"
 #include "sdl/errors.h"
 #include "sdl/font.h"
 #include "sdl/font_manager.h"
+#include "sdl/glyph_cache.h"
 #include "sdl/image_manager.h"
+#include "sdl/layer_stack.h"
 #include "sdl/lib.h"
 #include "sdl/lib_image.h"
 #include "sdl/lib_ttf.h"
 #include "sdl/renderer.h"
+#include "sdl/resource_registry.h"
+#include "sdl/skyline_packer.h"
+#include "sdl/sprite_batch.h"
+#include "sdl/streaming_texture.h"
 #include "sdl/surface.h"
+#include "sdl/text_cache.h"
 #include "sdl/texture.h"
+#include "sdl/texture_atlas.h"
+#include "sdl/texture_cache.h"
 #include "sdl/window.h"
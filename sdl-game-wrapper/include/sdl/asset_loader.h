@@ -0,0 +1,352 @@
+#pragma once
+#include <SDL.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "errors.h"
+#include "font.h"
+#include "font_manager.h"
+#include "image_manager.h"
+#include "renderer.h"
+#include "surface.h"
+#include "texture.h"
+
+namespace sgw {
+
+	enum class load_status {
+		pending,
+		ready,
+		failed
+	};
+
+	template <typename Resource>
+	struct load_ticket {
+		struct state {
+			std::atomic<load_status> status{ load_status::pending };
+			Resource resource{};
+			std::optional<sdl::texture> texture;
+			std::string error;
+		};
+
+		load_ticket() = default;
+		explicit load_ticket(std::shared_ptr<state> state) : m_state(std::move(state)) {}
+
+		[[nodiscard]] load_status get_status() const noexcept {
+			return m_state ? m_state->status.load(std::memory_order_acquire) : load_status::failed;
+		}
+
+		[[nodiscard]] bool is_ready() const noexcept { return get_status() == load_status::ready; }
+		[[nodiscard]] bool has_failed() const noexcept { return get_status() == load_status::failed; }
+
+		[[nodiscard]] const Resource& get() const {
+			check_ready();
+			return m_state->resource;
+		}
+
+		[[nodiscard]] const sdl::texture& get_texture() const {
+			check_ready();
+			if (!m_state->texture) {
+				throw std::logic_error("asset was not loaded with a texture upload");
+			}
+
+			return *m_state->texture;
+		}
+
+		[[nodiscard]] std::string_view get_error() const {
+			return m_state && has_failed() ? std::string_view(m_state->error) : std::string_view();
+		}
+
+	private:
+		void check_ready() const {
+			if (get_status() == load_status::failed) {
+				throw std::runtime_error(m_state ? m_state->error : "invalid load ticket");
+			}
+			if (get_status() != load_status::ready) {
+				throw std::logic_error("asset is still loading");
+			}
+		}
+
+		std::shared_ptr<state> m_state;
+	};
+
+	using image_ticket = load_ticket<image_resource>;
+	using font_ticket = load_ticket<font_resource>;
+
+	struct asset_loader {
+		static constexpr std::chrono::microseconds default_frame_budget{ 2000 };
+
+		asset_loader() : asset_loader(0) {}
+		explicit asset_loader(std::size_t thread_count)
+			: m_thread_count(thread_count != 0 ? thread_count : std::max<std::size_t>(1, std::thread::hardware_concurrency())) {}
+
+		asset_loader(const asset_loader&) = delete;
+		asset_loader(asset_loader&&) = delete;
+		asset_loader& operator=(const asset_loader&) = delete;
+		asset_loader& operator=(asset_loader&&) = delete;
+
+		~asset_loader() {
+			{
+				std::lock_guard lock(m_jobs_mutex);
+				m_stopping = true;
+			}
+			m_jobs_cv.notify_all();
+
+			for (auto& worker : m_workers) {
+				worker.join();
+			}
+
+			// tickets can outlive the loader and must not stay pending forever
+			for (auto& item : m_jobs) {
+				abandon(item.image_state);
+				abandon(item.font_state);
+			}
+			for (auto& item : m_completed) {
+				abandon(item.image_state);
+				abandon(item.font_state);
+			}
+		}
+
+		image_ticket load_image(std::string path, bool upload_texture = false) {
+			auto state = std::make_shared<image_ticket::state>();
+
+			enqueue(state, nullptr, [this, state, path = std::move(path), upload_texture]() {
+				completed item;
+				item.image_state = state;
+				item.upload_texture = upload_texture;
+
+				try {
+					item.surface = image_manager::load_image(path);
+				}
+				catch (const std::exception& ex) {
+					item.error = path + ": " + ex.what();
+				}
+
+				item.name = path;
+
+				push_completed(std::move(item));
+			});
+
+			return image_ticket(state);
+		}
+
+		font_ticket load_font(std::string path, std::string name, int point_size) {
+			auto state = std::make_shared<font_ticket::state>();
+
+			enqueue(nullptr, state, [this, state, path = std::move(path), name = std::move(name), point_size]() {
+				completed item;
+				item.font_state = state;
+				item.name = name;
+				item.point_size = point_size;
+
+				std::ifstream file(path, std::ios::binary);
+				if (file) {
+					item.font_data = std::make_shared<std::vector<char>>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+				}
+				else {
+					item.error = path + ": could not open font file";
+				}
+
+				push_completed(std::move(item));
+			});
+
+			return font_ticket(state);
+		}
+
+		std::size_t update(image_manager& images, font_manager& fonts, std::chrono::microseconds budget = default_frame_budget) {
+			return update_impl(images, fonts, nullptr, budget);
+		}
+
+		std::size_t update(image_manager& images, font_manager& fonts, const sdl::renderer& renderer, std::chrono::microseconds budget = default_frame_budget) {
+			return update_impl(images, fonts, &renderer, budget);
+		}
+
+		void wait_all(image_manager& images, font_manager& fonts, const sdl::renderer& renderer) {
+			while (m_in_flight.load(std::memory_order_acquire) != 0) {
+				{
+					std::unique_lock lock(m_completed_mutex);
+					m_completed_cv.wait(lock, [this]() { return !m_completed.empty(); });
+				}
+
+				update_impl(images, fonts, &renderer, std::nullopt);
+			}
+		}
+
+		[[nodiscard]] bool is_idle() const noexcept {
+			return m_in_flight.load(std::memory_order_acquire) == 0;
+		}
+
+		[[nodiscard]] std::size_t get_pending_count() const noexcept {
+			return m_in_flight.load(std::memory_order_acquire);
+		}
+
+	private:
+		struct completed {
+			std::shared_ptr<image_ticket::state> image_state;
+			std::shared_ptr<font_ticket::state> font_state;
+			std::optional<sdl::surface> surface;
+			std::shared_ptr<std::vector<char>> font_data;
+			std::string name;
+			int point_size = 0;
+			bool upload_texture = false;
+			std::string error;
+		};
+
+		// the ticket states are kept next to the job so the destructor can fail the ones never run
+		struct job {
+			std::shared_ptr<image_ticket::state> image_state;
+			std::shared_ptr<font_ticket::state> font_state;
+			std::function<void()> run;
+		};
+
+		void enqueue(std::shared_ptr<image_ticket::state> image_state, std::shared_ptr<font_ticket::state> font_state, std::function<void()> run) {
+			m_in_flight.fetch_add(1, std::memory_order_acq_rel);
+
+			{
+				std::lock_guard lock(m_jobs_mutex);
+				if (m_workers.empty()) {
+					for (std::size_t i = 0; i < m_thread_count; i++) {
+						m_workers.emplace_back([this]() { worker_loop(); });
+					}
+				}
+
+				m_jobs.push_back({ std::move(image_state), std::move(font_state), std::move(run) });
+			}
+			m_jobs_cv.notify_one();
+		}
+
+		void worker_loop() {
+			while (true) {
+				std::function<void()> run;
+
+				{
+					std::unique_lock lock(m_jobs_mutex);
+					m_jobs_cv.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+
+					if (m_stopping) {
+						return;
+					}
+
+					run = std::move(m_jobs.front().run);
+					m_jobs.pop_front();
+				}
+
+				run();
+			}
+		}
+
+		void push_completed(completed&& item) {
+			{
+				std::lock_guard lock(m_completed_mutex);
+				m_completed.push_back(std::move(item));
+			}
+			m_completed_cv.notify_one();
+		}
+
+		// without a budget everything completed so far is integrated
+		std::size_t update_impl(image_manager& images, font_manager& fonts, const sdl::renderer* renderer, std::optional<std::chrono::microseconds> budget) {
+			const auto start = std::chrono::steady_clock::now();
+			std::size_t processed = 0;
+
+			while (true) {
+				completed item;
+
+				{
+					std::lock_guard lock(m_completed_mutex);
+					if (m_completed.empty()) {
+						break;
+					}
+
+					item = std::move(m_completed.front());
+					m_completed.pop_front();
+				}
+
+				integrate(item, images, fonts, renderer);
+				m_in_flight.fetch_sub(1, std::memory_order_acq_rel);
+				processed++;
+
+				if (budget && std::chrono::steady_clock::now() - start >= *budget) {
+					break;
+				}
+			}
+
+			return processed;
+		}
+
+		template <typename State>
+		static void abandon(const std::shared_ptr<State>& state) {
+			if (state) {
+				state->error = "loader destroyed";
+				state->status.store(load_status::failed, std::memory_order_release);
+			}
+		}
+
+		static void integrate(completed& item, image_manager& images, font_manager& fonts, const sdl::renderer* renderer) {
+			if (item.image_state) {
+				auto& state = *item.image_state;
+
+				if (!item.surface) {
+					state.error = std::move(item.error);
+					state.status.store(load_status::failed, std::memory_order_release);
+					return;
+				}
+
+				try {
+					if (item.upload_texture && renderer != nullptr) {
+						state.texture = renderer->create_texture_from_surface(*item.surface);
+					}
+					state.resource = images.add_image(std::move(*item.surface), item.name);
+					state.status.store(load_status::ready, std::memory_order_release);
+				}
+				catch (const std::exception& ex) {
+					state.error = ex.what();
+					state.status.store(load_status::failed, std::memory_order_release);
+				}
+			}
+			else if (item.font_state) {
+				auto& state = *item.font_state;
+
+				try {
+					if (!item.font_data) {
+						throw std::runtime_error(item.error);
+					}
+
+					const auto* data = item.font_data->data();
+					const auto size = item.font_data->size();
+					sdl::font font(data, size, item.point_size, std::move(item.font_data));
+
+					state.resource = fonts.add_font(std::move(font), item.name);
+					state.status.store(load_status::ready, std::memory_order_release);
+				}
+				catch (const std::exception& ex) {
+					state.error = ex.what();
+					state.status.store(load_status::failed, std::memory_order_release);
+				}
+			}
+		}
+
+		std::size_t m_thread_count;
+		std::vector<std::thread> m_workers;
+
+		std::mutex m_jobs_mutex;
+		std::condition_variable m_jobs_cv;
+		std::deque<job> m_jobs;
+		bool m_stopping = false;
+
+		std::mutex m_completed_mutex;
+		std::condition_variable m_completed_cv;
+		std::deque<completed> m_completed;
+
+		std::atomic<std::size_t> m_in_flight{ 0 };
+	};
+}
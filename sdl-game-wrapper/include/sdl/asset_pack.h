@@ -0,0 +1,299 @@
+#pragma once
+#include <SDL.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "errors.h"
+#include "font.h"
+#include "font_manager.h"
+#include "image_manager.h"
+#include "surface.h"
+
+namespace sgw {
+
+	// on disk layout: header, entries sorted by name, the name table, then the 64 byte aligned data
+	// blobs. images are stored decoded in the pixel format chosen at pack time, fonts as raw files
+	enum class asset_pack_entry_type : std::uint32_t {
+		image = 1,
+		font = 2
+	};
+
+	struct asset_pack_header {
+		static constexpr std::array<char, 4> expected_magic{ 'S', 'G', 'W', 'P' };
+		static constexpr std::uint32_t current_version = 1;
+
+		std::array<char, 4> magic;
+		std::uint32_t version;
+		std::uint32_t entry_count;
+		std::uint32_t names_size;
+	};
+
+	struct asset_pack_entry {
+		std::uint64_t data_offset;
+		std::uint64_t data_size;
+		std::uint32_t name_offset;
+		std::uint32_t name_size;
+		asset_pack_entry_type type;
+		Uint32 format;
+		std::int32_t width;
+		std::int32_t height;
+		std::int32_t pitch;
+		std::uint32_t reserved;
+	};
+
+	static_assert(sizeof(asset_pack_header) == 16 && sizeof(asset_pack_entry) == 48);
+	static_assert(std::endian::native == std::endian::little, "asset packs are stored little endian");
+
+	inline constexpr std::size_t asset_pack_alignment = 64;
+
+	// read only view of a whole file. mapped copy on write so SDL may scribble on surface pixels
+	struct mapped_file {
+		mapped_file() = delete;
+		explicit mapped_file(const std::string& path) {
+#if defined(_WIN32)
+			m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+			if (m_file == INVALID_HANDLE_VALUE) {
+				throw sdl::file_map_error(path);
+			}
+
+			LARGE_INTEGER size;
+			GetFileSizeEx(m_file, &size);
+			m_size = static_cast<std::size_t>(size.QuadPart);
+
+			if (m_size != 0) {
+				m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+				m_data = m_mapping != nullptr ? static_cast<std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_COPY, 0, 0, 0)) : nullptr;
+				if (m_data == nullptr) {
+					close();
+					throw sdl::file_map_error(path);
+				}
+			}
+#else
+			m_file = ::open(path.c_str(), O_RDONLY);
+			if (m_file == -1) {
+				throw sdl::file_map_error(path);
+			}
+
+			struct stat info {};
+			fstat(m_file, &info);
+			m_size = static_cast<std::size_t>(info.st_size);
+
+			if (m_size != 0) {
+				auto* data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, m_file, 0);
+				if (data == MAP_FAILED) {
+					close();
+					throw sdl::file_map_error(path);
+				}
+				m_data = static_cast<std::byte*>(data);
+			}
+#endif
+		}
+
+		mapped_file(const mapped_file&) = delete;
+		mapped_file(mapped_file&&) = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+		mapped_file& operator=(mapped_file&&) = delete;
+
+		~mapped_file() {
+			close();
+		}
+
+		[[nodiscard]] std::byte* data() const noexcept { return m_data; }
+		[[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+	private:
+		void close() noexcept {
+#if defined(_WIN32)
+			if (m_data != nullptr) {
+				UnmapViewOfFile(m_data);
+			}
+			if (m_mapping != nullptr) {
+				CloseHandle(m_mapping);
+			}
+			if (m_file != INVALID_HANDLE_VALUE) {
+				CloseHandle(m_file);
+			}
+			m_mapping = nullptr;
+			m_file = INVALID_HANDLE_VALUE;
+#else
+			if (m_data != nullptr) {
+				munmap(m_data, m_size);
+			}
+			if (m_file != -1) {
+				::close(m_file);
+			}
+			m_file = -1;
+#endif
+			m_data = nullptr;
+		}
+
+#if defined(_WIN32)
+		HANDLE m_file = INVALID_HANDLE_VALUE;
+		HANDLE m_mapping = nullptr;
+#else
+		int m_file = -1;
+#endif
+		std::byte* m_data = nullptr;
+		std::size_t m_size = 0;
+	};
+
+	// a pack written by tools/asset_packer, memory mapped. surfaces and fonts built from it point
+	// straight into the mapping and keep it alive. copies share the mapping
+	struct asset_pack {
+		asset_pack() = delete;
+		explicit asset_pack(const std::string& path) : m_file(std::make_shared<mapped_file>(path)) {
+			auto size = m_file->size();
+			if (size < sizeof(asset_pack_header)) {
+				throw sdl::asset_pack_error(path + ": not an asset pack");
+			}
+
+			std::memcpy(&m_header, m_file->data(), sizeof(m_header));
+			if (m_header.magic != asset_pack_header::expected_magic || m_header.version != asset_pack_header::current_version) {
+				throw sdl::asset_pack_error(path + ": not an asset pack or unsupported version");
+			}
+
+			auto entries_end = sizeof(asset_pack_header) + static_cast<std::size_t>(m_header.entry_count) * sizeof(asset_pack_entry);
+			if (entries_end + m_header.names_size > size) {
+				throw sdl::asset_pack_error(path + ": truncated");
+			}
+
+			m_entries = reinterpret_cast<const asset_pack_entry*>(m_file->data() + sizeof(asset_pack_header));
+			m_names = reinterpret_cast<const char*>(m_file->data() + entries_end);
+
+			for (std::uint32_t i = 0; i < m_header.entry_count; i++) {
+				const auto& current = m_entries[i];
+				if (current.name_offset + static_cast<std::size_t>(current.name_size) > m_header.names_size
+					|| current.data_offset > size || current.data_size > size - current.data_offset) {
+					throw sdl::asset_pack_error(path + ": corrupt entry");
+				}
+
+				if (current.type == asset_pack_entry_type::image ? !is_valid_image(current) : current.type != asset_pack_entry_type::font) {
+					throw sdl::asset_pack_error(path + ": corrupt entry");
+				}
+			}
+		}
+
+		asset_pack(const asset_pack&) = default;
+		asset_pack(asset_pack&&) noexcept = default;
+		asset_pack& operator=(const asset_pack&) = default;
+		asset_pack& operator=(asset_pack&&) noexcept = default;
+		~asset_pack() = default;
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_header.entry_count; }
+
+		[[nodiscard]] std::string_view get_name(const asset_pack_entry& entry) const noexcept {
+			return { m_names + entry.name_offset, entry.name_size };
+		}
+
+		[[nodiscard]] const asset_pack_entry* find(std::string_view name) const noexcept {
+			const auto* end = m_entries + m_header.entry_count;
+			const auto* found = std::lower_bound(m_entries, end, name, [this](const asset_pack_entry& entry, std::string_view value) {
+				return get_name(entry) < value;
+			});
+
+			return found != end && get_name(*found) == name ? found : nullptr;
+		}
+
+		[[nodiscard]] bool contains(std::string_view name, asset_pack_entry_type type) const noexcept {
+			const auto* entry = find(name);
+			return entry != nullptr && entry->type == type;
+		}
+
+		template <typename Func>
+		void for_each(Func func) const {
+			for (std::uint32_t i = 0; i < m_header.entry_count; i++) {
+				func(get_name(m_entries[i]), m_entries[i]);
+			}
+		}
+
+		[[nodiscard]] sdl::surface load_image(std::string_view name) const {
+			const auto& entry = get_entry(name, asset_pack_entry_type::image);
+			return sdl::surface(m_file->data() + entry.data_offset, entry.width, entry.height, entry.pitch, entry.format, m_file);
+		}
+
+		[[nodiscard]] sdl::font load_font(std::string_view name, int point_size) const {
+			const auto& entry = get_entry(name, asset_pack_entry_type::font);
+			return sdl::font(m_file->data() + entry.data_offset, static_cast<std::size_t>(entry.data_size), point_size, m_file);
+		}
+
+		// add_image and ensure_image look packed paths up here instead of decoding the file
+		void mount(image_manager& images) const {
+			images.add_source([pack = *this](std::string_view path) -> std::optional<sdl::surface> {
+				if (!pack.contains(path, asset_pack_entry_type::image)) {
+					return std::nullopt;
+				}
+
+				return pack.load_image(path);
+			});
+		}
+
+		void mount(font_manager& fonts) const {
+			fonts.add_source([pack = *this](std::string_view path, int point_size) -> std::optional<sdl::font> {
+				if (!pack.contains(path, asset_pack_entry_type::font)) {
+					return std::nullopt;
+				}
+
+				return pack.load_font(path, point_size);
+			});
+		}
+
+	private:
+		// the surface built from an image entry reads pitch * height bytes of its blob
+		[[nodiscard]] static bool is_valid_image(const asset_pack_entry& entry) noexcept {
+			switch (entry.format) {
+			case SDL_PIXELFORMAT_ARGB8888:
+			case SDL_PIXELFORMAT_ABGR8888:
+			case SDL_PIXELFORMAT_RGBA8888:
+			case SDL_PIXELFORMAT_BGRA8888:
+				break;
+			default:
+				return false;
+			}
+
+			if (entry.width <= 0 || entry.height <= 0 || entry.pitch <= 0) {
+				return false;
+			}
+
+			auto row_size = static_cast<std::uint64_t>(entry.width) * SDL_BYTESPERPIXEL(entry.format);
+			auto pitch = static_cast<std::uint64_t>(entry.pitch);
+			return pitch >= row_size && pitch * static_cast<std::uint64_t>(entry.height) <= entry.data_size;
+		}
+
+		[[nodiscard]] const asset_pack_entry& get_entry(std::string_view name, asset_pack_entry_type type) const {
+			const auto* entry = find(name);
+			if (entry == nullptr || entry->type != type) {
+				throw sdl::resource_not_found_error();
+			}
+
+			return *entry;
+		}
+
+		std::shared_ptr<mapped_file> m_file;
+		asset_pack_header m_header{};
+		const asset_pack_entry* m_entries = nullptr;
+		const char* m_names = nullptr;
+	};
+}
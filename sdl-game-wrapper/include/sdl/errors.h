@@ -1,6 +1,7 @@
 #pragma once
 #include <SDL.h>
 #include <stdexcept>
+#include <string>
 #include <string_view>
 
 namespace sdl {
@@ -44,6 +45,10 @@ namespace sdl {
 		renderer_draw_color_error() : std::runtime_error(SDL_GetError()) {}
 	};
 
+	struct renderer_target_error : public std::runtime_error {
+		renderer_target_error() : std::runtime_error(SDL_GetError()) {}
+	};
+
 	struct font_open_error : public std::runtime_error {
 		font_open_error() : std::runtime_error(SDL_GetError()) {}
 	};
@@ -52,6 +57,14 @@ namespace sdl {
 		invalid_texture_error() : std::runtime_error(SDL_GetError()) {}
 	};
 
+	struct texture_lock_error : public std::runtime_error {
+		texture_lock_error() : std::runtime_error(SDL_GetError()) {}
+	};
+
+	struct texture_update_error : public std::runtime_error {
+		texture_update_error() : std::runtime_error(SDL_GetError()) {}
+	};
+
 	struct invalid_surface_error : public std::runtime_error {
 		invalid_surface_error() : std::runtime_error(SDL_GetError()) {}
 	};
@@ -59,4 +72,28 @@ namespace sdl {
 	struct surface_null_error : public std::runtime_error {
 		surface_null_error() : std::runtime_error("Surface is null") {}
 	};
+
+	struct surface_dropped_error : public std::runtime_error {
+		surface_dropped_error() : std::runtime_error("Surface was dropped after upload and has to be reloaded") {}
+	};
+
+	struct stale_resource_error : public std::runtime_error {
+		stale_resource_error() : std::runtime_error("Resource handle is no longer valid") {}
+	};
+
+	struct resource_not_found_error : public std::runtime_error {
+		resource_not_found_error() : std::runtime_error("No resource with that name is loaded") {}
+	};
+
+	struct file_map_error : public std::runtime_error {
+		explicit file_map_error(const std::string& path) : std::runtime_error("Could not map " + path) {}
+	};
+
+	struct asset_pack_error : public std::runtime_error {
+		explicit asset_pack_error(const std::string& message) : std::runtime_error(message) {}
+	};
+
+	struct input_log_error : public std::runtime_error {
+		explicit input_log_error(const std::string& message) : std::runtime_error(message) {}
+	};
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 #include <SDL.h>
 #include <SDL_ttf.h>
+#include <atomic>
+#include <cstdint>
 #include <string_view>
+#include <memory>
 #include "errors.h"
 #include "lib_ttf.h"
 #include "surface.h"
@@ -15,17 +18,21 @@ namespace sdl {
 		font(const font&) = delete;
 		font(font&& other) noexcept {
 			std::swap(m_font_ptr, other.m_font_ptr);
+			std::swap(m_id, other.m_id);
 			std::swap(m_point_size, other.m_point_size);
+			std::swap(m_font_data, other.m_font_data);
 		};
 
 		font& operator=(const font&) = delete;
 		font& operator=(font&& other) noexcept {
 			std::swap(m_font_ptr, other.m_font_ptr);
+			std::swap(m_id, other.m_id);
 			std::swap(m_point_size, other.m_point_size);
+			std::swap(m_font_data, other.m_font_data);
 			return *this;
 		}
 
-		font(std::string_view path, int point_size) : m_point_size(point_size) {
+		font(std::string_view path, int point_size) : m_id(next_id()), m_point_size(point_size) {
 			m_font_ptr = TTF_OpenFont(path.data(), point_size);
 
 			if (m_font_ptr == nullptr) {
@@ -33,6 +40,15 @@ namespace sdl {
 			}
 		}
 
+		font(const void* data, std::size_t size, int point_size, std::shared_ptr<const void> keep_alive)
+			: m_id(next_id()), m_point_size(point_size), m_font_data(std::move(keep_alive)) {
+			m_font_ptr = TTF_OpenFontRW(SDL_RWFromConstMem(data, static_cast<int>(size)), 1, point_size);
+
+			if (m_font_ptr == nullptr) {
+				throw font_open_error();
+			}
+		}
+
 		~font() {
 			if (m_font_ptr != nullptr) {
 				TTF_CloseFont(m_font_ptr);
@@ -59,10 +75,55 @@ namespace sdl {
 			return sdl::surface(TTF_RenderText_Blended(m_font_ptr, text.data(), color));
 		}
 
+		[[nodiscard]] sdl::surface render_glyph_blended(Uint16 glyph, const SDL_Color& color) const {
+			return sdl::surface(TTF_RenderGlyph_Blended(m_font_ptr, glyph, color));
+		}
+
+		[[nodiscard]] bool has_glyph(Uint16 glyph) const {
+			return TTF_GlyphIsProvided(m_font_ptr, glyph) != 0;
+		}
+
+		[[nodiscard]] int glyph_advance(Uint16 glyph) const {
+			int advance = 0;
+			if (TTF_GlyphMetrics(m_font_ptr, glyph, nullptr, nullptr, nullptr, nullptr, &advance) == -1) {
+				return 0;
+			}
+
+			return advance;
+		}
+
+		[[nodiscard]] int kerning(Uint16 previous, Uint16 current) const {
+			return TTF_GetFontKerningSizeGlyphs(m_font_ptr, previous, current);
+		}
+
+		[[nodiscard]] int height() const {
+			return TTF_FontHeight(m_font_ptr);
+		}
+
+		[[nodiscard]] int line_skip() const {
+			return TTF_FontLineSkip(m_font_ptr);
+		}
+
+		[[nodiscard]] int get_point_size() const noexcept {
+			return m_point_size;
+		}
+
+		// unique for every opened font, unlike its address which a reloaded font may reuse
+		[[nodiscard]] std::uint32_t get_id() const noexcept {
+			return m_id;
+		}
+
 
 	private:
+		[[nodiscard]] static std::uint32_t next_id() noexcept {
+			static std::atomic<std::uint32_t> counter{ 0 };
+			return ++counter;
+		}
+
 		TTF_Font* m_font_ptr = nullptr;
+		std::uint32_t m_id = 0;
 		int m_point_size = 0;
+		std::shared_ptr<const void> m_font_data;
 		friend renderer;
 	};
 }
\ No newline at end of file
@@ -1,18 +1,24 @@
 #pragma once
 #include <SDL.h>
 #include <SDL_ttf.h>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
 #include <string_view>
-#include <map>
 #include <utility>
+#include <vector>
 #include "errors.h"
 #include "font.h"
+#include "resource_registry.h"
 
 namespace sgw {
 
-	enum class font_resource : std::size_t {};
+	enum class font_resource : std::uint32_t {};
 
 	struct font_manager {
-		using key = std::pair<std::string_view, int>;
+		using key = font_resource;
+		using font_source = std::function<std::optional<sdl::font>(std::string_view path, int point_size)>;
 
 		font_manager() = default;
 		font_manager(const font_manager&) = delete;
@@ -25,25 +31,80 @@ namespace sgw {
 			return m_lib_ttf;
 		}
 
-		auto add_font(std::string_view path, std::string_view name, int point_size) {
-			sdl::font f(path, point_size);
-			auto key = std::make_pair(name, point_size);
-			m_loaded_fonts.insert(std::make_pair(key, std::move(f)));
-			return key;
+		// loading a name and point size that is already loaded adds a reference instead
+		font_resource add_font(std::string_view path, std::string_view name, int point_size) {
+			auto interned = make_name(name, point_size);
+			if (auto existing = m_fonts.find(interned)) {
+				m_fonts.retain(*existing);
+				return *existing;
+			}
+
+			return m_fonts.add(load_font(path, point_size), interned);
+		}
+
+		// sources are asked in the order they were added before falling back to the file system
+		void add_source(font_source source) {
+			m_sources.push_back(std::move(source));
+		}
+
+		font_resource add_font(sdl::font&& font, std::string_view name) {
+			auto interned = make_name(name, font.get_point_size());
+			return m_fonts.add(std::move(font), interned);
 		}
 
 		[[nodiscard]] const sdl::font& get_font(std::string_view name, int point_size) const {
-			auto& value = m_loaded_fonts.at(std::make_pair(name, point_size));
-			return value;
+			auto handle = m_fonts.find(make_name(name, point_size));
+			if (!handle) {
+				throw sdl::resource_not_found_error();
+			}
+
+			return m_fonts.get(*handle);
 		}
 
-		[[nodiscard]] const sdl::font& get_font(key key) const {
-			auto& value = m_loaded_fonts.at(key);
-			return value;
+		[[nodiscard]] const sdl::font& get_font(font_resource font) const {
+			return m_fonts.get(font);
+		}
+
+		[[nodiscard]] std::optional<font_resource> find_font(std::string_view name, int point_size) const {
+			return m_fonts.find(make_name(name, point_size));
+		}
+
+		[[nodiscard]] bool is_loaded(font_resource font) const noexcept {
+			return m_fonts.is_valid(font);
+		}
+
+		void retain_font(font_resource font) {
+			m_fonts.retain(font);
+		}
+
+		bool release_font(font_resource font) {
+			return m_fonts.release(font);
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept {
+			return m_fonts.size();
 		}
 
 	private:
+		[[nodiscard]] sdl::font load_font(std::string_view path, int point_size) const {
+			for (const auto& source : m_sources) {
+				if (auto font = source(path, point_size)) {
+					return std::move(*font);
+				}
+			}
+
+			return sdl::font(path, point_size);
+		}
+
+		[[nodiscard]] static std::string make_name(std::string_view name, int point_size) {
+			std::string interned(name);
+			interned.push_back('@');
+			interned.append(std::to_string(point_size));
+			return interned;
+		}
+
 		sdl::lib_ttf m_lib_ttf;
-		std::map<key, sdl::font> m_loaded_fonts;
+		resource_registry<sdl::font, font_resource> m_fonts;
+		std::vector<font_source> m_sources;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,202 @@
+#pragma once
+#include <SDL.h>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include "errors.h"
+#include "font.h"
+#include "renderer.h"
+#include "sprite_batch.h"
+#include "texture_atlas.h"
+
+namespace sgw {
+
+	struct glyph_cache {
+		static constexpr int default_page_size = 512;
+		static constexpr Uint16 first_preloaded_glyph = 32;
+		static constexpr Uint16 last_preloaded_glyph = 126;
+		static constexpr Uint16 fallback_glyph = '?';
+
+		struct glyph {
+			std::optional<atlas_region> region;
+			int width = 0;
+			int height = 0;
+			int advance = 0;
+		};
+
+		glyph_cache() = delete;
+		glyph_cache(const sdl::font& font, const sdl::renderer& renderer)
+			: glyph_cache(font, renderer, default_page_size) {}
+
+		glyph_cache(const sdl::font& font, const sdl::renderer& renderer, int page_size)
+			: m_font(font), m_renderer(renderer), m_atlas(page_size, page_size, 1), m_line_skip(font.line_skip()) {
+			for (Uint16 c = first_preloaded_glyph; c <= last_preloaded_glyph; c++) {
+				m_missing.push_back(c);
+			}
+			load_missing();
+		}
+
+		glyph_cache(const glyph_cache&) = delete;
+		glyph_cache(glyph_cache&&) = delete;
+		glyph_cache& operator=(const glyph_cache&) = delete;
+		glyph_cache& operator=(glyph_cache&&) = delete;
+		~glyph_cache() = default;
+
+		[[nodiscard]] const sdl::font& get_font() const noexcept { return m_font; }
+		[[nodiscard]] const texture_atlas& get_atlas() const noexcept { return m_atlas; }
+
+		[[nodiscard]] const glyph& get_glyph(Uint16 codepoint) {
+			auto it = m_glyphs.find(codepoint);
+			if (it != m_glyphs.end()) {
+				return it->second;
+			}
+
+			m_missing.push_back(codepoint);
+			load_missing();
+			return m_glyphs.at(codepoint);
+		}
+
+		[[nodiscard]] std::pair<int, int> measure(std::string_view text) {
+			prepare(text);
+
+			int width = 0;
+			int line_width = 0;
+			int height = m_line_skip;
+			Uint16 previous = 0;
+
+			for_each_codepoint(text, [&](Uint16 c) {
+				if (c == '\n') {
+					width = std::max(width, line_width);
+					line_width = 0;
+					height += m_line_skip;
+					previous = 0;
+					return;
+				}
+
+				if (previous != 0) {
+					line_width += m_font.kerning(previous, c);
+				}
+				line_width += m_glyphs.at(c).advance;
+				previous = c;
+			});
+
+			return { std::max(width, line_width), height };
+		}
+
+		template <typename FloatPoint = SDL_FPoint>
+		void submit(sdl::sprite_batch& batch, std::string_view text, const FloatPoint& position, const SDL_Color& color, sdl::sprite_params params = {}) {
+			prepare(text);
+			params.color = color;
+
+			float x = position.x;
+			float y = position.y;
+			Uint16 previous = 0;
+
+			for_each_codepoint(text, [&](Uint16 c) {
+				if (c == '\n') {
+					x = position.x;
+					y += static_cast<float>(m_line_skip);
+					previous = 0;
+					return;
+				}
+
+				if (previous != 0) {
+					x += static_cast<float>(m_font.kerning(previous, c));
+				}
+
+				const auto& g = m_glyphs.at(c);
+				if (g.region) {
+					auto sprite = m_atlas.get(*g.region);
+					batch.submit(sprite.texture, SDL_FRect{ x, y, static_cast<float>(g.width), static_cast<float>(g.height) }, sprite.source, params);
+				}
+
+				x += static_cast<float>(g.advance);
+				previous = c;
+			});
+		}
+
+		template <typename FloatPoint = SDL_FPoint>
+		void draw(std::string_view text, const FloatPoint& position, const SDL_Color& color) {
+			m_batch.begin();
+			submit(m_batch, text, position, color);
+			m_batch.flush(m_renderer);
+		}
+
+	private:
+		void prepare(std::string_view text) {
+			for_each_codepoint(text, [&](Uint16 c) {
+				if (c != '\n' && m_glyphs.find(c) == m_glyphs.end() &&
+					std::find(m_missing.begin(), m_missing.end(), c) == m_missing.end()) {
+					m_missing.push_back(c);
+				}
+			});
+
+			if (!m_missing.empty()) {
+				load_missing();
+			}
+		}
+
+		void load_missing() {
+			std::vector<std::pair<Uint16, sdl::surface>> rendered;
+			rendered.reserve(m_missing.size());
+
+			for (auto c : m_missing) {
+				auto source = m_font.has_glyph(c) ? c : fallback_glyph;
+				glyph g;
+				g.advance = m_font.glyph_advance(source);
+
+				try {
+					auto surface = m_font.render_glyph_blended(source, { 255, 255, 255, 255 });
+					g.width = surface.get_width();
+					g.height = surface.get_height();
+					rendered.emplace_back(c, std::move(surface));
+				}
+				catch (const sdl::invalid_surface_error&) {
+					// whitespace and empty glyphs have nothing to rasterize
+				}
+
+				m_glyphs.insert_or_assign(c, g);
+			}
+			m_missing.clear();
+
+			if (rendered.empty()) {
+				return;
+			}
+
+			for (auto& [c, surface] : rendered) {
+				m_glyphs.at(c).region = m_atlas.add(surface);
+			}
+			m_atlas.build(m_renderer);
+		}
+
+		template <typename Func>
+		static void for_each_codepoint(std::string_view text, Func func) {
+			for (std::size_t i = 0; i < text.size();) {
+				auto lead = static_cast<unsigned char>(text[i]);
+				std::size_t length = lead < 0x80 ? 1 : (lead >> 5U) == 0x6 ? 2 : (lead >> 4U) == 0xE ? 3 : (lead >> 3U) == 0x1E ? 4 : 1;
+
+				if (i + length > text.size()) {
+					break;
+				}
+
+				std::uint32_t codepoint = length == 1 ? lead : lead & (0xFFU >> (length + 1));
+				for (std::size_t j = 1; j < length; j++) {
+					codepoint = (codepoint << 6U) | (static_cast<unsigned char>(text[i + j]) & 0x3FU);
+				}
+
+				func(codepoint > 0xFFFF ? fallback_glyph : static_cast<Uint16>(codepoint));
+				i += length;
+			}
+		}
+
+		const sdl::font& m_font;
+		const sdl::renderer& m_renderer;
+		texture_atlas m_atlas;
+		sdl::sprite_batch m_batch{ 256 };
+		std::unordered_map<Uint16, glyph> m_glyphs;
+		std::vector<Uint16> m_missing;
+		int m_line_skip;
+	};
+}
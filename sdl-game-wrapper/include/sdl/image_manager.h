@@ -1,20 +1,26 @@
 #pragma once
 #include <SDL.h>
 #include <SDL_ttf.h>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
 #include <string_view>
-#include <map>
 #include <utility>
+#include <vector>
 #include "surface.h"
 #include "errors.h"
 #include "lib_image.h"
+#include "resource_registry.h"
 #include "texture.h"
 
 namespace sgw {
 
-	enum class image_resource : std::size_t {};
+	enum class image_resource : std::uint32_t {};
 
 	struct image_manager {
-		using key = std::string_view;
+		using key = image_resource;
+		using image_source = std::function<std::optional<sdl::surface>(std::string_view path)>;
 
 		image_manager() = delete;
 		explicit image_manager(Uint32 lib_image_flags) : m_lib_image(lib_image_flags) {}
@@ -28,29 +34,104 @@ namespace sgw {
 			return m_lib_image;
 		}
 
-		//[[nodiscard]] static sdl::surface load_image(std::string_view path) {
-		//	return sdl::surface(IMG_Load(path.data()));
-		//}
-
 		[[nodiscard]] static sdl::surface load_image(const std::string& path) {
 			return sdl::surface(IMG_Load(path.c_str()));
 		}
 
+		// images are interned by path, loading the same path again adds a reference instead
 		image_resource add_image(std::string_view path) {
-			image_resource img{ m_images_amount };
-			sdl::surface s(IMG_Load(path.data()));
-			m_loaded_images.insert(std::make_pair(img, std::move(s)));
-			m_images_amount++;
-			return img;
+			if (auto existing = m_images.find(path)) {
+				m_images.retain(*existing);
+				return *existing;
+			}
+
+			return m_images.add(load_from_sources(path), path);
+		}
+
+		// sources are asked in the order they were added before falling back to IMG_Load
+		void add_source(image_source source) {
+			m_sources.push_back(std::move(source));
+		}
+
+		image_resource add_image(sdl::surface&& surface) {
+			return m_images.add(std::move(surface));
+		}
+
+		image_resource add_image(sdl::surface&& surface, std::string_view path) {
+			return m_images.add(std::move(surface), path);
+		}
+
+		[[nodiscard]] const sdl::surface& get_image(image_resource image) const {
+			const auto& surface = m_images.get(image);
+			if (!surface) {
+				throw sdl::surface_dropped_error();
+			}
+
+			return *surface;
+		}
+
+		// like get_image, but reloads a dropped surface from its path
+		const sdl::surface& ensure_image(image_resource image) {
+			auto& surface = m_images.get(image);
+			if (!surface) {
+				surface = load_from_sources(m_images.get_name(image));
+			}
+
+			return *surface;
+		}
+
+		[[nodiscard]] bool has_surface(image_resource image) const {
+			const auto* surface = m_images.try_get(image);
+			return surface != nullptr && surface->has_value();
 		}
 
-		[[nodiscard]] const sdl::surface& get_image(image_resource name) const {
-			return m_loaded_images.at(name);
+		// frees the system memory copy of an image that can be reloaded from its path
+		bool drop_surface(image_resource image) {
+			if (!m_images.is_valid(image) || m_images.get_name(image).empty()) {
+				return false;
+			}
+
+			m_images.get(image).reset();
+			return true;
+		}
+
+		[[nodiscard]] std::optional<image_resource> find_image(std::string_view path) const {
+			return m_images.find(path);
+		}
+
+		[[nodiscard]] std::string_view get_path(image_resource image) const {
+			return m_images.get_name(image);
+		}
+
+		[[nodiscard]] bool is_loaded(image_resource image) const noexcept {
+			return m_images.is_valid(image);
+		}
+
+		void retain_image(image_resource image) {
+			m_images.retain(image);
+		}
+
+		bool release_image(image_resource image) {
+			return m_images.release(image);
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept {
+			return m_images.size();
 		}
 
 	private:
+		[[nodiscard]] sdl::surface load_from_sources(std::string_view path) const {
+			for (const auto& source : m_sources) {
+				if (auto surface = source(path)) {
+					return std::move(*surface);
+				}
+			}
+
+			return load_image(std::string(path));
+		}
+
 		sdl::lib_image m_lib_image;
-		std::map<image_resource, sdl::surface> m_loaded_images;
-		std::size_t m_images_amount{ 0 };
+		resource_registry<std::optional<sdl::surface>, image_resource> m_images;
+		std::vector<image_source> m_sources;
 	};
-}
\ No newline at end of file
+}
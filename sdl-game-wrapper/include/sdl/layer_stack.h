@@ -0,0 +1,241 @@
+#pragma once
+#include <SDL.h>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "renderer.h"
+#include "texture.h"
+
+namespace sgw {
+
+	using layer_id = std::uint32_t;
+
+	struct layer_params {
+		int order = 0;
+		bool cached = true;
+		// used to composite cached layers, whose contents are premultiplied by alpha; the clear
+		// color is written as is and so counts as premultiplied too. a renderer that rejects the
+		// mode composites with SDL_BLENDMODE_BLEND instead and translucent pixels come out darker
+		SDL_BlendMode blend_mode = sdl::premultiplied_blend_mode();
+		SDL_Color clear_color{ 0, 0, 0, 0 };
+	};
+
+	// layers render into output sized target textures that are only redrawn when marked dirty,
+	// then composited with one copy each in ascending order. uncached layers draw straight to
+	// the output every frame
+	struct layer_stack {
+		using draw_func = std::function<void(const sdl::renderer&)>;
+
+		// game::draw composites the layers ordered below this before game_draw and the rest after
+		static constexpr int game_order = 0;
+
+		explicit layer_stack(const sdl::renderer& renderer) : m_renderer(renderer) {}
+
+		layer_stack(const layer_stack&) = delete;
+		layer_stack(layer_stack&&) = delete;
+		layer_stack& operator=(const layer_stack&) = delete;
+		layer_stack& operator=(layer_stack&&) = delete;
+		~layer_stack() = default;
+
+		layer_id add_layer(std::string name, draw_func draw, layer_params params = {}) {
+			auto id = static_cast<layer_id>(m_layers.size());
+			m_layers.push_back({ .name = std::move(name), .draw = std::move(draw), .params = params });
+
+			auto position = std::upper_bound(m_order.begin(), m_order.end(), params.order, [this](int order, layer_id other) {
+				return order < m_layers[other].params.order;
+			});
+			m_order.insert(position, id);
+
+			return id;
+		}
+
+		void remove_layer(layer_id id) {
+			auto& current = get_layer(id);
+			current.draw = nullptr;
+			current.target.reset();
+			current.removed = true;
+			m_order.erase(std::find(m_order.begin(), m_order.end(), id));
+		}
+
+		[[nodiscard]] std::optional<layer_id> find_layer(std::string_view name) const {
+			for (auto id : m_order) {
+				if (m_layers[id].name == name) {
+					return id;
+				}
+			}
+
+			return std::nullopt;
+		}
+
+		void set_draw(layer_id id, draw_func draw) {
+			auto& current = get_layer(id);
+			current.draw = std::move(draw);
+			current.dirty = true;
+		}
+
+		void mark_dirty(layer_id id) {
+			get_layer(id).dirty = true;
+		}
+
+		void mark_all_dirty() noexcept {
+			for (auto& current : m_layers) {
+				current.dirty = true;
+			}
+		}
+
+		[[nodiscard]] bool is_dirty(layer_id id) const {
+			return get_layer(id).dirty;
+		}
+
+		void set_visible(layer_id id, bool visible) {
+			get_layer(id).visible = visible;
+		}
+
+		[[nodiscard]] bool is_visible(layer_id id) const {
+			return get_layer(id).visible;
+		}
+
+		// turning caching off frees the target, useful for content that changes every frame anyway
+		void set_cached(layer_id id, bool cached) {
+			auto& current = get_layer(id);
+			current.params.cached = cached;
+			current.dirty = true;
+
+			if (!cached) {
+				current.target.reset();
+			}
+		}
+
+		// drops every target, e.g. after SDL_RENDER_TARGETS_RESET. they are recreated on the next draw
+		void invalidate() noexcept {
+			for (auto& current : m_layers) {
+				current.target.reset();
+				current.dirty = true;
+			}
+		}
+
+		void draw() {
+			draw_range(INT_MIN, INT_MAX);
+		}
+
+		void draw_below(int order) {
+			if (order != INT_MIN) {
+				draw_range(INT_MIN, order - 1);
+			}
+		}
+
+		void draw_from(int order) {
+			draw_range(order, INT_MAX);
+		}
+
+		// expects the default render target to be set, and leaves it set
+		void draw_range(int first_order, int last_order) {
+			auto first = std::lower_bound(m_order.begin(), m_order.end(), first_order, [this](layer_id id, int order) {
+				return m_layers[id].params.order < order;
+			});
+			auto last = std::upper_bound(first, m_order.end(), last_order, [this](int order, layer_id id) {
+				return order < m_layers[id].params.order;
+			});
+
+			if (first == last) {
+				return;
+			}
+
+			auto output_size = m_renderer.get_output_size();
+			if (output_size != m_output_size) {
+				invalidate();
+				m_output_size = output_size;
+			}
+
+			// redraw everything dirty first so the render target switches back only once
+			bool redrawn = false;
+			for (auto it = first; it != last; ++it) {
+				auto& current = m_layers[*it];
+				if (current.visible && current.params.cached && current.dirty) {
+					redraw(current);
+					redrawn = true;
+				}
+			}
+
+			if (redrawn) {
+				m_renderer.set_default_render_target();
+			}
+
+			for (auto it = first; it != last; ++it) {
+				auto& current = m_layers[*it];
+				if (!current.visible) {
+					continue;
+				}
+
+				if (current.params.cached) {
+					m_renderer.copy(*current.target);
+					m_composites++;
+				}
+				else if (current.draw) {
+					current.draw(m_renderer);
+				}
+			}
+		}
+
+		[[nodiscard]] bool empty() const noexcept { return m_order.empty(); }
+		[[nodiscard]] std::size_t size() const noexcept { return m_order.size(); }
+		[[nodiscard]] std::size_t get_redraw_count() const noexcept { return m_redraws; }
+		[[nodiscard]] std::size_t get_composite_count() const noexcept { return m_composites; }
+
+	private:
+		struct layer {
+			std::string name;
+			draw_func draw;
+			layer_params params;
+			std::optional<sdl::texture> target;
+			bool dirty = true;
+			bool visible = true;
+			bool removed = false;
+		};
+
+		[[nodiscard]] layer& get_layer(layer_id id) {
+			return const_cast<layer&>(std::as_const(*this).get_layer(id));
+		}
+
+		[[nodiscard]] const layer& get_layer(layer_id id) const {
+			if (id >= m_layers.size() || m_layers[id].removed) {
+				throw std::out_of_range("unknown layer");
+			}
+
+			return m_layers[id];
+		}
+
+		void redraw(layer& current) {
+			if (!current.target) {
+				auto [w, h] = m_output_size;
+				current.target = m_renderer.create_texture(SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, w, h);
+				current.target->set_blend_mode_or_blend(current.params.blend_mode);
+			}
+
+			m_renderer.set_render_target(*current.target);
+			m_renderer.clear(current.params.clear_color);
+
+			if (current.draw) {
+				current.draw(m_renderer);
+			}
+
+			current.dirty = false;
+			m_redraws++;
+		}
+
+		const sdl::renderer& m_renderer;
+		std::vector<layer> m_layers;
+		std::vector<layer_id> m_order;
+		std::pair<int, int> m_output_size{ 0, 0 };
+
+		std::size_t m_redraws = 0;
+		std::size_t m_composites = 0;
+	};
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include <SDL.h>
 #include <string_view>
+#include <utility>
 #include "font.h"
 #include "errors.h"
 #include "window.h"
@@ -17,6 +18,37 @@ namespace sdl {
 	};
 
 	struct texture;
+	struct sprite_batch;
+	struct renderer;
+
+	// restores the render target that was set before renderer::push_render_target
+	struct guard_render_target {
+
+		guard_render_target() = delete;
+		guard_render_target(const guard_render_target&) = delete;
+		guard_render_target(guard_render_target&& other) noexcept {
+			std::swap(m_renderer, other.m_renderer);
+			std::swap(m_previous, other.m_previous);
+		}
+
+		guard_render_target& operator=(const guard_render_target&) = delete;
+		guard_render_target& operator=(guard_render_target&& other) noexcept {
+			std::swap(m_renderer, other.m_renderer);
+			std::swap(m_previous, other.m_previous);
+			return *this;
+		}
+
+		~guard_render_target();
+
+	private:
+		guard_render_target(const renderer* p_renderer, SDL_Texture* previous)
+			: m_renderer{ p_renderer }, m_previous{ previous } {}
+
+		const renderer* m_renderer{ nullptr };
+		SDL_Texture* m_previous{ nullptr };
+
+		friend renderer;
+	};
 	struct renderer {
 
 		enum class flags : unsigned int {
@@ -29,12 +61,12 @@ namespace sdl {
 		renderer() = delete;
 		renderer(const renderer&) = delete;
 		renderer(renderer&& other) noexcept {
-			std::swap(m_renderer_ptr, other.m_renderer_ptr);
+			swap_state(other);
 		}
 
 		renderer& operator=(const renderer&) = delete;
 		renderer& operator=(renderer&& other) noexcept {
-			std::swap(m_renderer_ptr, other.m_renderer_ptr);
+			swap_state(other);
 			return *this;
 		}
 
@@ -50,27 +82,26 @@ namespace sdl {
 			if (m_renderer_ptr == nullptr) {
 				throw renderer_create_error();
 			}
-		}
 
-		void set_draw_color(const SDL_Color& color) const {
-			if (SDL_SetRenderDrawColor(m_renderer_ptr, color.r, color.g, color.b, color.a) == -1) {
+			if (SDL_GetRenderDrawColor(m_renderer_ptr, &m_draw_color.r, &m_draw_color.g, &m_draw_color.b, &m_draw_color.a) == -1) {
 				throw renderer_draw_color_error();
 			}
+			m_current_draw_color = m_draw_color;
+
+			SDL_GetRenderDrawBlendMode(m_renderer_ptr, &m_blend_mode);
+		}
+
+		void set_draw_color(const SDL_Color& color) const {
+			m_draw_color = color;
+			apply_draw_color(color);
 		}
 
 		void set_draw_color(uint8_t r, uint8_t g, uint8_t b, uint8_t a) const {
-			if (SDL_SetRenderDrawColor(m_renderer_ptr, r, g, b, a) == -1) {
-				throw renderer_draw_color_error();
-			}
+			set_draw_color(SDL_Color{ r, g, b, a });
 		}
 
 		[[nodiscard]] SDL_Color get_draw_color() const {
-			SDL_Color c;
-			if (SDL_GetRenderDrawColor(m_renderer_ptr, &c.r, &c.g, &c.b, &c.a) == -1) {
-				throw renderer_draw_color_error(); 
-			}
-
-			return c;
+			return m_draw_color;
 		}
 
 		template<typename IntegerPointType = std::pair<int, int>>
@@ -110,47 +141,66 @@ namespace sdl {
 		}
 
 		[[nodiscard]] SDL_BlendMode get_blend_mode() const {
-			SDL_BlendMode bm;
-			if (SDL_GetRenderDrawBlendMode(m_renderer_ptr, &bm) == -1) {
-				// TODO: throw error;
-			}
-			return bm;
+			return m_blend_mode;
 		}
 
 		void set_blend_mode(SDL_BlendMode blend_mode) const {
+			if (blend_mode == m_blend_mode) {
+				return;
+			}
+
 			if (SDL_SetRenderDrawBlendMode(m_renderer_ptr, blend_mode) == -1) {
 				// TODO: throw error;
+				return;
 			}
+			m_blend_mode = blend_mode;
 		}
 
 		void set_render_target(const texture& target) const {
-			if (SDL_SetRenderTarget(m_renderer_ptr, target.m_texture_ptr) == -1) {
-				// TODO: throw error
-			}
+			set_render_target_ptr(target.m_texture_ptr);
 		}
 
 		void set_default_render_target() const {
-			if (SDL_SetRenderTarget(m_renderer_ptr, nullptr) == -1) {
-				// TODO: throw error
-			}
+			set_render_target_ptr(nullptr);
+		}
+
+		[[nodiscard]] guard_render_target push_render_target(const texture& target) const {
+			sync_render_target();
+			guard_render_target guard{ this, m_render_target };
+			set_render_target(target);
+			return guard;
+		}
+
+		[[nodiscard]] bool is_default_render_target() const noexcept {
+			sync_render_target();
+			return m_render_target == nullptr;
 		}
 
 		void set_scale(float scale_x, float scale_y) const {
+			if (scale_x == m_scale_x && scale_y == m_scale_y) {
+				return;
+			}
+
 			if (SDL_RenderSetScale(m_renderer_ptr, scale_x, scale_y) == -1) {
 				// TODO: throw error
+				return;
 			}
+			m_scale_x = scale_x;
+			m_scale_y = scale_y;
 		}
 
 		template<typename PointType = std::pair<float, float>>
 		PointType get_scale() const {
-			float x;
-			float y;
-			SDL_RenderGetScale(m_renderer_ptr, &x, &y);
-
-			return { x, y };
+			return { m_scale_x, m_scale_y };
 		}
 
 		void clear() const {
+			apply_draw_color(m_draw_color);
+			SDL_RenderClear(m_renderer_ptr);
+		}
+
+		void clear(const SDL_Color& color) const {
+			apply_draw_color(color);
 			SDL_RenderClear(m_renderer_ptr);
 		}
 
@@ -352,21 +402,65 @@ namespace sdl {
 
 	private:
 
+		void swap_state(renderer& other) noexcept {
+			std::swap(m_renderer_ptr, other.m_renderer_ptr);
+			std::swap(m_draw_color, other.m_draw_color);
+			std::swap(m_current_draw_color, other.m_current_draw_color);
+			std::swap(m_blend_mode, other.m_blend_mode);
+			std::swap(m_render_target, other.m_render_target);
+			std::swap(m_scale_x, other.m_scale_x);
+			std::swap(m_scale_y, other.m_scale_y);
+		}
+
+		void apply_draw_color(const SDL_Color& color) const {
+			if (color.r == m_current_draw_color.r && color.g == m_current_draw_color.g &&
+				color.b == m_current_draw_color.b && color.a == m_current_draw_color.a) {
+				return;
+			}
+
+			if (SDL_SetRenderDrawColor(m_renderer_ptr, color.r, color.g, color.b, color.a) == -1) {
+				throw renderer_draw_color_error();
+			}
+			m_current_draw_color = color;
+		}
+
+		// destroying the bound target texture makes SDL fall back to the default target on its own,
+		// and a new texture may later get the old address. SDL_GetRenderTarget only reads a field
+		void sync_render_target() const noexcept {
+			auto* bound = SDL_GetRenderTarget(m_renderer_ptr);
+			if (bound != m_render_target) {
+				m_render_target = bound;
+				SDL_RenderGetScale(m_renderer_ptr, &m_scale_x, &m_scale_y);
+			}
+		}
+
+		void set_render_target_ptr(SDL_Texture* target) const {
+			sync_render_target();
+			if (target == m_render_target) {
+				return;
+			}
+
+			if (SDL_SetRenderTarget(m_renderer_ptr, target) == -1) {
+				throw renderer_target_error();
+			}
+			m_render_target = target;
+
+			// SDL keeps a separate scale per render target
+			SDL_RenderGetScale(m_renderer_ptr, &m_scale_x, &m_scale_y);
+		}
+
 		template <typename Func>
 		void generic_draw(const SDL_Color& color, Func func) const {
-			auto old_color = get_draw_color();
-			set_draw_color(color);
-
-			bool error = func() == -1;
-			set_draw_color(old_color);
+			apply_draw_color(color);
 
-			if (error) {
+			if (func() == -1) {
 				throw renderer_draw_error();
 			}
 		}
 
 		template <typename Func>
 		void generic_draw(Func func) const {
+			apply_draw_color(m_draw_color);
 			bool error = func() == -1;
 
 			if (error) {
@@ -375,6 +469,29 @@ namespace sdl {
 		}
 
 		SDL_Renderer* m_renderer_ptr = nullptr;
+
+		mutable SDL_Color m_draw_color{ 0, 0, 0, 255 };
+		mutable SDL_Color m_current_draw_color{ 0, 0, 0, 255 };
+		mutable SDL_BlendMode m_blend_mode = SDL_BLENDMODE_NONE;
+		mutable SDL_Texture* m_render_target = nullptr;
+		mutable float m_scale_x = 1.f;
+		mutable float m_scale_y = 1.f;
+
 		friend texture;
+		friend sprite_batch;
+		friend guard_render_target;
 	};
-}
\ No newline at end of file
+
+	inline guard_render_target::~guard_render_target() {
+		if (m_renderer == nullptr) {
+			return;
+		}
+
+		// destructors can't throw, and a renderer that lost its device is reported by the next draw
+		try {
+			m_renderer->set_render_target_ptr(m_previous);
+		}
+		catch (const renderer_target_error&) {
+		}
+	}
+}
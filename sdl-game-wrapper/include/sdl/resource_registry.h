@@ -0,0 +1,219 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "errors.h"
+
+namespace sgw {
+
+	// handles are 32 bit enums: the low bits index a slot, the high bits hold the slot's
+	// generation so a handle to an unloaded resource can't alias whatever reuses the slot
+	template <typename Handle>
+	struct resource_handle_traits {
+		static_assert(std::is_enum_v<Handle> && sizeof(Handle) == sizeof(std::uint32_t));
+
+		static constexpr std::uint32_t index_bits = 20;
+		static constexpr std::uint32_t index_mask = (1U << index_bits) - 1;
+		static constexpr std::uint32_t generation_mask = ~index_mask >> index_bits;
+		static constexpr std::uint32_t max_slots = index_mask;
+
+		[[nodiscard]] static constexpr Handle make(std::uint32_t index, std::uint32_t generation) noexcept {
+			return static_cast<Handle>(((generation & generation_mask) << index_bits) | index);
+		}
+
+		[[nodiscard]] static constexpr std::uint32_t index(Handle handle) noexcept {
+			return static_cast<std::uint32_t>(handle) & index_mask;
+		}
+
+		[[nodiscard]] static constexpr std::uint32_t generation(Handle handle) noexcept {
+			return static_cast<std::uint32_t>(handle) >> index_bits;
+		}
+	};
+
+	template <typename Resource, typename Handle>
+	struct resource_registry {
+		using handle_type = Handle;
+		using traits = resource_handle_traits<Handle>;
+
+		resource_registry() = default;
+		resource_registry(const resource_registry&) = delete;
+		resource_registry(resource_registry&&) noexcept = default;
+		resource_registry& operator=(const resource_registry&) = delete;
+		resource_registry& operator=(resource_registry&&) noexcept = default;
+		~resource_registry() = default;
+
+		// a resource added under a name that is already loaded is dropped and the existing handle retained
+		Handle add(Resource&& resource, std::string_view name = {}) {
+			if (!name.empty()) {
+				if (auto existing = find(name)) {
+					retain(*existing);
+					return *existing;
+				}
+			}
+
+			std::uint32_t index;
+			if (!m_free.empty()) {
+				index = m_free.back();
+				m_free.pop_back();
+			}
+			else {
+				if (m_generations.size() >= traits::max_slots) {
+					throw std::length_error("resource registry is full");
+				}
+
+				index = static_cast<std::uint32_t>(m_generations.size());
+				if (index % page_size == 0) {
+					m_pages.push_back(std::make_unique<page>());
+				}
+				m_generations.push_back(0);
+				m_ref_counts.push_back(0);
+				m_names.emplace_back();
+			}
+
+			slot(index).emplace(std::move(resource));
+			m_ref_counts[index] = 1;
+			auto handle = traits::make(index, m_generations[index]);
+
+			if (!name.empty()) {
+				m_names[index] = name;
+				m_by_name.emplace(m_names[index], handle);
+			}
+
+			return handle;
+		}
+
+		[[nodiscard]] bool is_valid(Handle handle) const noexcept {
+			auto index = traits::index(handle);
+			return index < m_generations.size() && slot(index).has_value() && m_generations[index] == traits::generation(handle);
+		}
+
+		[[nodiscard]] const Resource& get(Handle handle) const {
+			if (!is_valid(handle)) {
+				throw sdl::stale_resource_error();
+			}
+
+			return *slot(traits::index(handle));
+		}
+
+		[[nodiscard]] Resource& get(Handle handle) {
+			if (!is_valid(handle)) {
+				throw sdl::stale_resource_error();
+			}
+
+			return *slot(traits::index(handle));
+		}
+
+		[[nodiscard]] const Resource* try_get(Handle handle) const noexcept {
+			return is_valid(handle) ? &*slot(traits::index(handle)) : nullptr;
+		}
+
+		[[nodiscard]] std::optional<Handle> find(std::string_view name) const {
+			auto it = m_by_name.find(name);
+			if (it == m_by_name.end()) {
+				return std::nullopt;
+			}
+
+			return it->second;
+		}
+
+		[[nodiscard]] std::string_view get_name(Handle handle) const {
+			return is_valid(handle) ? std::string_view(m_names[traits::index(handle)]) : std::string_view();
+		}
+
+		void retain(Handle handle) {
+			if (!is_valid(handle)) {
+				throw sdl::stale_resource_error();
+			}
+
+			m_ref_counts[traits::index(handle)]++;
+		}
+
+		// unloads the resource once the last reference is released, returns true when it did
+		bool release(Handle handle) {
+			if (!is_valid(handle)) {
+				return false;
+			}
+
+			auto index = traits::index(handle);
+			if (--m_ref_counts[index] != 0) {
+				return false;
+			}
+
+			unload(index);
+			return true;
+		}
+
+		void remove(Handle handle) {
+			if (is_valid(handle)) {
+				unload(traits::index(handle));
+			}
+		}
+
+		[[nodiscard]] std::size_t get_ref_count(Handle handle) const noexcept {
+			return is_valid(handle) ? m_ref_counts[traits::index(handle)] : 0;
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept {
+			return m_generations.size() - m_free.size();
+		}
+
+		template <typename Func>
+		void for_each(Func func) const {
+			for (std::uint32_t index = 0; index < m_generations.size(); index++) {
+				if (const auto& current = slot(index)) {
+					func(traits::make(index, m_generations[index]), *current);
+				}
+			}
+		}
+
+	private:
+		// slots live in fixed size pages that never move, so references handed out by get()
+		// survive later adds while neighbouring slots stay contiguous
+		static constexpr std::uint32_t page_size = 64;
+		using page = std::array<std::optional<Resource>, page_size>;
+
+		[[nodiscard]] std::optional<Resource>& slot(std::uint32_t index) noexcept {
+			return (*m_pages[index / page_size])[index % page_size];
+		}
+
+		[[nodiscard]] const std::optional<Resource>& slot(std::uint32_t index) const noexcept {
+			return (*m_pages[index / page_size])[index % page_size];
+		}
+
+		struct name_hash {
+			using is_transparent = void;
+
+			std::size_t operator()(std::string_view name) const noexcept {
+				return std::hash<std::string_view>{}(name);
+			}
+		};
+
+		void unload(std::uint32_t index) {
+			if (!m_names[index].empty()) {
+				m_by_name.erase(m_by_name.find(std::string_view(m_names[index])));
+				m_names[index].clear();
+			}
+
+			slot(index).reset();
+			m_ref_counts[index] = 0;
+			m_generations[index] = (m_generations[index] + 1) & traits::generation_mask;
+			m_free.push_back(index);
+		}
+
+		std::vector<std::unique_ptr<page>> m_pages;
+		std::vector<std::uint32_t> m_generations;
+		std::vector<std::uint32_t> m_ref_counts;
+		std::vector<std::string> m_names;
+		std::vector<std::uint32_t> m_free;
+		std::unordered_map<std::string, Handle, name_hash, std::equal_to<>> m_by_name;
+	};
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include <optional>
+#include <limits>
+#include <algorithm>
+
+namespace sgw {
+
+	struct skyline_packer {
+
+		skyline_packer() = delete;
+		skyline_packer(int width, int height) : m_width(width), m_height(height) {
+			m_skyline.push_back({ 0, 0, width });
+		}
+
+		[[nodiscard]] int get_width() const noexcept { return m_width; }
+		[[nodiscard]] int get_height() const noexcept { return m_height; }
+		[[nodiscard]] long long get_used_area() const noexcept { return m_used_area; }
+
+		[[nodiscard]] std::optional<SDL_Rect> insert(int w, int h) {
+			if (w <= 0 || h <= 0 || w > m_width || h > m_height) {
+				return std::nullopt;
+			}
+
+			int best_index = -1;
+			int best_y = std::numeric_limits<int>::max();
+			int best_width = std::numeric_limits<int>::max();
+
+			for (std::size_t i = 0; i < m_skyline.size(); i++) {
+				auto y = fit(i, w, h);
+				if (!y) {
+					continue;
+				}
+
+				auto node_width = m_skyline[i].width;
+				if (*y < best_y || (*y == best_y && node_width < best_width)) {
+					best_index = static_cast<int>(i);
+					best_y = *y;
+					best_width = node_width;
+				}
+			}
+
+			if (best_index == -1) {
+				return std::nullopt;
+			}
+
+			SDL_Rect rect{ m_skyline[best_index].x, best_y, w, h };
+			add_level(static_cast<std::size_t>(best_index), rect);
+			m_used_area += static_cast<long long>(w) * h;
+
+			return rect;
+		}
+
+		void clear() {
+			m_skyline.clear();
+			m_skyline.push_back({ 0, 0, m_width });
+			m_used_area = 0;
+		}
+
+	private:
+		struct node {
+			int x;
+			int y;
+			int width;
+		};
+
+		[[nodiscard]] std::optional<int> fit(std::size_t index, int w, int h) const {
+			auto x = m_skyline[index].x;
+			if (x + w > m_width) {
+				return std::nullopt;
+			}
+
+			int width_left = w;
+			int y = m_skyline[index].y;
+
+			while (width_left > 0) {
+				if (index >= m_skyline.size()) {
+					return std::nullopt;
+				}
+
+				y = std::max(y, m_skyline[index].y);
+				if (y + h > m_height) {
+					return std::nullopt;
+				}
+
+				width_left -= m_skyline[index].width;
+				index++;
+			}
+
+			return y;
+		}
+
+		void add_level(std::size_t index, const SDL_Rect& rect) {
+			m_skyline.insert(m_skyline.begin() + static_cast<std::ptrdiff_t>(index), { rect.x, rect.y + rect.h, rect.w });
+
+			for (auto i = index + 1; i < m_skyline.size(); i++) {
+				auto& previous = m_skyline[i - 1];
+				auto& current = m_skyline[i];
+
+				if (current.x >= previous.x + previous.width) {
+					break;
+				}
+
+				auto shrink = previous.x + previous.width - current.x;
+				current.x += shrink;
+				current.width -= shrink;
+
+				if (current.width > 0) {
+					break;
+				}
+
+				m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(i));
+				i--;
+			}
+
+			for (std::size_t i = 0; i + 1 < m_skyline.size(); i++) {
+				if (m_skyline[i].y == m_skyline[i + 1].y) {
+					m_skyline[i].width += m_skyline[i + 1].width;
+					m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(i) + 1);
+					i--;
+				}
+			}
+		}
+
+		int m_width;
+		int m_height;
+		long long m_used_area = 0;
+		std::vector<node> m_skyline;
+	};
+}
@@ -0,0 +1,240 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include "errors.h"
+#include "texture.h"
+#include "renderer.h"
+
+namespace sdl {
+
+	struct sprite_params {
+		std::uint8_t layer = 0;
+		std::uint32_t depth = 0;
+		double rotation = 0.0;
+		SDL_BlendMode blend_mode = SDL_BLENDMODE_BLEND;
+		SDL_Color color{ 255, 255, 255, 255 };
+		SDL_RendererFlip flip = SDL_FLIP_NONE;
+	};
+
+	struct sprite_batch_stats {
+		std::size_t submitted = 0;
+		std::size_t draw_calls = 0;
+		std::size_t texture_switches = 0;
+		std::size_t blend_mode_switches = 0;
+		std::size_t color_mod_switches = 0;
+
+		[[nodiscard]] std::size_t state_switches() const noexcept {
+			return texture_switches + blend_mode_switches + color_mod_switches;
+		}
+	};
+
+	struct sprite_batch {
+		static constexpr std::size_t default_capacity = 1024;
+
+		sprite_batch() {
+			reserve(default_capacity);
+		}
+
+		explicit sprite_batch(std::size_t capacity) {
+			reserve(capacity);
+		}
+
+		sprite_batch(const sprite_batch&) = delete;
+		sprite_batch(sprite_batch&&) noexcept = default;
+		sprite_batch& operator=(const sprite_batch&) = delete;
+		sprite_batch& operator=(sprite_batch&&) noexcept = default;
+		~sprite_batch() = default;
+
+		void reserve(std::size_t capacity) {
+			m_commands.reserve(capacity);
+			m_order.reserve(capacity);
+		}
+
+		void begin() {
+			m_commands.clear();
+			m_order.clear();
+			m_stats = {};
+			m_sorted = true;
+		}
+
+		void submit(const texture& texture, const SDL_FRect& destination_rect, const sprite_params& params = {}) {
+			push(texture, destination_rect, nullptr, params);
+		}
+
+		void submit(const texture& texture, const SDL_FRect& destination_rect, const SDL_Rect& source_rect, const sprite_params& params = {}) {
+			push(texture, destination_rect, &source_rect, params);
+		}
+
+		template <typename PointType>
+		void submit_centered(const texture& texture, const PointType& position, const sprite_params& params = {}) {
+			auto [wi, hi] = texture.get_size();
+			auto w = static_cast<float>(wi);
+			auto h = static_cast<float>(hi);
+			push(texture, SDL_FRect{ position.x - (w / 2.f), position.y - (h / 2.f), w, h }, nullptr, params);
+		}
+
+		// flush sorts on its own, sorting up front lets batches recorded on other threads be sorted there
+		void sort() {
+			if (!m_sorted) {
+				std::sort(m_order.begin(), m_order.end());
+				m_sorted = true;
+			}
+		}
+
+		// appends batches that were sorted with sort() and keeps the result sorted, merging the runs
+		// pairwise. equal keys keep the order of the batches. the merged batches are left empty
+		void merge_sorted(std::span<sprite_batch* const> batches) {
+			sort();
+
+			m_runs.clear();
+			m_runs.push_back(0);
+			if (!m_order.empty()) {
+				m_runs.push_back(m_order.size());
+			}
+
+			for (auto* batch : batches) {
+				if (batch->empty()) {
+					continue;
+				}
+
+				batch->sort();
+				auto offset = static_cast<std::uint32_t>(m_commands.size());
+				m_commands.insert(m_commands.end(), batch->m_commands.begin(), batch->m_commands.end());
+				for (const auto& [key, index] : batch->m_order) {
+					m_order.emplace_back(key, index + offset);
+				}
+				m_runs.push_back(m_order.size());
+				m_stats.submitted += batch->m_stats.submitted;
+
+				batch->m_commands.clear();
+				batch->m_order.clear();
+				batch->m_sorted = true;
+			}
+
+			while (m_runs.size() > 2) {
+				m_scratch.resize(m_order.size());
+				std::size_t merged_runs = 1;
+
+				for (std::size_t run = 0; run + 1 < m_runs.size(); run += 2) {
+					auto first = m_order.begin() + static_cast<std::ptrdiff_t>(m_runs[run]);
+					auto middle = m_order.begin() + static_cast<std::ptrdiff_t>(m_runs[run + 1]);
+					auto last = run + 2 < m_runs.size() ? m_order.begin() + static_cast<std::ptrdiff_t>(m_runs[run + 2]) : middle;
+					std::merge(first, middle, middle, last, m_scratch.begin() + static_cast<std::ptrdiff_t>(m_runs[run]));
+					m_runs[merged_runs++] = run + 2 < m_runs.size() ? m_runs[run + 2] : m_runs[run + 1];
+				}
+
+				m_runs.resize(merged_runs);
+				std::swap(m_order, m_scratch);
+			}
+		}
+
+		void flush(const renderer& renderer) {
+			sort();
+
+			const texture* current_texture = nullptr;
+			SDL_BlendMode current_blend_mode = SDL_BLENDMODE_INVALID;
+			SDL_Color current_color{ 0, 0, 0, 0 };
+
+			for (const auto& [key, index] : m_order) {
+				const auto& command = m_commands[index];
+				const bool texture_changed = command.texture_ptr != current_texture;
+
+				if (texture_changed) {
+					current_texture = command.texture_ptr;
+					m_stats.texture_switches++;
+				}
+
+				if (texture_changed || command.blend_mode != current_blend_mode) {
+					current_texture->set_blend_mode(command.blend_mode);
+					current_blend_mode = command.blend_mode;
+					m_stats.blend_mode_switches++;
+				}
+
+				if (texture_changed || !same_color(command.color, current_color)) {
+					current_texture->set_color_mod(command.color.r, command.color.g, command.color.b);
+					current_texture->set_alpha_mod(command.color.a);
+					current_color = command.color;
+					m_stats.color_mod_switches++;
+				}
+
+				const SDL_Rect* source = command.has_source ? &command.source : nullptr;
+				if (SDL_RenderCopyExF(renderer.m_renderer_ptr, current_texture->m_texture_ptr, source, &command.destination, command.rotation, nullptr, command.flip) == -1) {
+					throw renderer_copy_error();
+				}
+
+				m_stats.draw_calls++;
+			}
+
+			m_commands.clear();
+			m_order.clear();
+			m_sorted = true;
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_commands.size(); }
+		[[nodiscard]] bool empty() const noexcept { return m_commands.empty(); }
+		[[nodiscard]] const sprite_batch_stats& get_stats() const noexcept { return m_stats; }
+
+		// layer (8) | texture id (24) | blend mode (8) | depth (24), ties keep submission order
+		[[nodiscard]] static std::uint64_t make_sort_key(std::uint8_t layer, std::uint32_t texture_id, SDL_BlendMode blend_mode, std::uint32_t depth) noexcept {
+			return (static_cast<std::uint64_t>(layer) << 56U) |
+				   (static_cast<std::uint64_t>(texture_id & 0xFFFFFFU) << 32U) |
+				   (static_cast<std::uint64_t>(blend_mode_index(blend_mode)) << 24U) |
+				   static_cast<std::uint64_t>(depth & 0xFFFFFFU);
+		}
+
+	private:
+		struct command {
+			const sdl::texture* texture_ptr;
+			SDL_FRect destination;
+			SDL_Rect source;
+			double rotation;
+			SDL_Color color;
+			SDL_BlendMode blend_mode;
+			SDL_RendererFlip flip;
+			bool has_source;
+		};
+
+		void push(const texture& texture, const SDL_FRect& destination_rect, const SDL_Rect* source_rect, const sprite_params& params) {
+			auto index = static_cast<std::uint32_t>(m_commands.size());
+			m_commands.push_back({
+				.texture_ptr	= &texture,
+				.destination	= destination_rect,
+				.source			= source_rect != nullptr ? *source_rect : SDL_Rect{ 0, 0, 0, 0 },
+				.rotation		= params.rotation,
+				.color			= params.color,
+				.blend_mode		= params.blend_mode,
+				.flip			= params.flip,
+				.has_source		= source_rect != nullptr
+			});
+			m_order.emplace_back(make_sort_key(params.layer, texture.get_id(), params.blend_mode, params.depth), index);
+			m_stats.submitted++;
+			m_sorted = false;
+		}
+
+		[[nodiscard]] static std::uint8_t blend_mode_index(SDL_BlendMode blend_mode) noexcept {
+			switch (blend_mode) {
+			case SDL_BLENDMODE_NONE: return 0;
+			case SDL_BLENDMODE_BLEND: return 1;
+			case SDL_BLENDMODE_ADD: return 2;
+			case SDL_BLENDMODE_MOD: return 3;
+			case SDL_BLENDMODE_MUL: return 4;
+			default: return 5;
+			}
+		}
+
+		[[nodiscard]] static bool same_color(const SDL_Color& a, const SDL_Color& b) noexcept {
+			return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+		}
+
+		std::vector<command> m_commands;
+		std::vector<std::pair<std::uint64_t, std::uint32_t>> m_order;
+		std::vector<std::pair<std::uint64_t, std::uint32_t>> m_scratch;
+		std::vector<std::size_t> m_runs;
+		sprite_batch_stats m_stats;
+		bool m_sorted = true;
+	};
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <SDL.h>
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "errors.h"
+#include "renderer.h"
+#include "texture.h"
+
+namespace sdl {
+
+	// a set of streaming textures cycled as a ring: the CPU writes the back buffer while the
+	// front one, published by the last swap(), is drawn. the contents of a locked buffer are
+	// undefined, so with more than one buffer every frame has to rewrite what it needs
+	struct streaming_texture {
+		static constexpr std::size_t max_buffers = 3;
+
+		streaming_texture() = delete;
+		streaming_texture(const renderer& renderer, Uint32 format, int w, int h, std::size_t buffer_count = 1) {
+			buffer_count = std::clamp<std::size_t>(buffer_count, 1, max_buffers);
+
+			m_buffers.reserve(buffer_count);
+			for (std::size_t i = 0; i < buffer_count; i++) {
+				m_buffers.push_back(renderer.create_texture(format, SDL_TEXTUREACCESS_STREAMING, w, h));
+			}
+
+			m_back = buffer_count > 1 ? 1 : 0;
+		}
+
+		streaming_texture(const streaming_texture&) = delete;
+		streaming_texture(streaming_texture&&) noexcept = default;
+		streaming_texture& operator=(const streaming_texture&) = delete;
+		streaming_texture& operator=(streaming_texture&&) noexcept = default;
+		~streaming_texture() = default;
+
+		[[nodiscard]] guard_texture_lock lock() const {
+			return m_buffers[m_back].lock();
+		}
+
+		[[nodiscard]] guard_texture_lock lock(const SDL_Rect& rect) const {
+			return m_buffers[m_back].lock(rect);
+		}
+
+		void update(const void* pixels, int pitch) const {
+			m_buffers[m_back].update(pixels, pitch);
+		}
+
+		void update(const SDL_Rect& rect, const void* pixels, int pitch) const {
+			m_buffers[m_back].update(rect, pixels, pitch);
+		}
+
+		// publishes the back buffer for drawing and moves writing on to the next one
+		void swap() noexcept {
+			if (m_buffers.size() == 1) {
+				return;
+			}
+
+			m_front = m_back;
+			m_back = (m_back + 1) % m_buffers.size();
+		}
+
+		[[nodiscard]] const texture& get_texture() const noexcept {
+			return m_buffers[m_front];
+		}
+
+		[[nodiscard]] const texture& get_back_texture() const noexcept {
+			return m_buffers[m_back];
+		}
+
+		[[nodiscard]] std::size_t get_buffer_count() const noexcept {
+			return m_buffers.size();
+		}
+
+		template<typename SizeType = std::pair<int, int>>
+		[[nodiscard]] SizeType get_size() const {
+			return m_buffers.front().template get_size<SizeType>();
+		}
+
+		[[nodiscard]] Uint32 get_format() const noexcept {
+			return m_buffers.front().get_format();
+		}
+
+	private:
+		std::vector<texture> m_buffers;
+		std::size_t m_front = 0;
+		std::size_t m_back = 0;
+	};
+}
@@ -1,9 +1,12 @@
 #pragma once
 #include <SDL.h>
+#include <memory>
+#include <utility>
 #include "errors.h"
 
 namespace sgw {
 	struct image_manager;
+	struct texture_atlas;
 }
 
 namespace sdl {
@@ -16,14 +19,26 @@ namespace sdl {
 		surface(const surface&) = delete;
 		surface(surface&& other) noexcept {
 			std::swap(m_surface_ptr, other.m_surface_ptr);
+			std::swap(m_pixel_data, other.m_pixel_data);
 		};
 
 		surface& operator=(const surface&) = delete;
 		surface& operator=(surface&& other) noexcept {
 			std::swap(m_surface_ptr, other.m_surface_ptr);
+			std::swap(m_pixel_data, other.m_pixel_data);
 			return *this;
 		}
 
+		// wraps pixels owned by someone else without copying them, keep_alive is released with the surface
+		surface(void* pixels, int width, int height, int pitch, Uint32 format, std::shared_ptr<const void> keep_alive)
+			: m_pixel_data(std::move(keep_alive)) {
+			m_surface_ptr = SDL_CreateRGBSurfaceWithFormatFrom(pixels, width, height, SDL_BITSPERPIXEL(format), pitch, format);
+
+			if (m_surface_ptr == nullptr) {
+				throw invalid_surface_error();
+			}
+		}
+
 		~surface() {
 			if (m_surface_ptr != nullptr) {
 				SDL_FreeSurface(m_surface_ptr);
@@ -68,9 +83,11 @@ namespace sdl {
 		}
 
 		SDL_Surface* m_surface_ptr = nullptr;
+		std::shared_ptr<const void> m_pixel_data;
 		friend renderer;
 		friend font;
 		friend texture;
 		friend sgw::image_manager;
+		friend sgw::texture_atlas;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,130 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "font.h"
+#include "renderer.h"
+#include "texture.h"
+
+namespace sgw {
+
+	struct text_cache {
+		static constexpr std::size_t default_max_idle_frames = 120;
+
+		text_cache() = default;
+		explicit text_cache(std::size_t max_idle_frames) : m_max_idle_frames(max_idle_frames) {}
+		text_cache(const text_cache&) = delete;
+		text_cache(text_cache&&) noexcept = default;
+		text_cache& operator=(const text_cache&) = delete;
+		text_cache& operator=(text_cache&&) noexcept = default;
+		~text_cache() = default;
+
+		// empty text gets a transparent 1x1 texture, SDL_ttf renders nothing for it
+		[[nodiscard]] const sdl::texture& get(const sdl::renderer& renderer, const sdl::font& font, std::string_view text, const SDL_Color& color) {
+			if (text.empty()) {
+				return get_empty(renderer);
+			}
+
+			make_key(font, text, color);
+
+			auto it = m_entries.find(m_key);
+			if (it == m_entries.end()) {
+				std::string null_terminated(text);
+				auto surface = font.render_blended(null_terminated, color);
+				it = m_entries.emplace(m_key, entry{ renderer.create_texture_from_surface(surface), m_frame }).first;
+				m_misses++;
+			}
+			else {
+				m_hits++;
+			}
+
+			it->second.last_used_frame = m_frame;
+			return it->second.texture;
+		}
+
+		template <typename FloatPoint = SDL_FPoint>
+		void draw(const sdl::renderer& renderer, const sdl::font& font, std::string_view text, const FloatPoint& position, const SDL_Color& color) {
+			if (text.empty()) {
+				return;
+			}
+
+			renderer.copy_f(get(renderer, font, text, color), position);
+		}
+
+		void end_frame() {
+			m_frame++;
+
+			for (auto it = m_entries.begin(); it != m_entries.end();) {
+				if (m_frame - it->second.last_used_frame > m_max_idle_frames) {
+					it = m_entries.erase(it);
+				}
+				else {
+					++it;
+				}
+			}
+		}
+
+		void clear() {
+			m_entries.clear();
+			m_empty.reset();
+		}
+
+		// drops the textures rendered with a font, call before releasing it
+		void invalidate(const sdl::font& font) {
+			for (auto it = m_entries.begin(); it != m_entries.end();) {
+				it = key_font_id(it->first) == font.get_id() ? m_entries.erase(it) : std::next(it);
+			}
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_entries.size(); }
+		[[nodiscard]] std::size_t get_hits() const noexcept { return m_hits; }
+		[[nodiscard]] std::size_t get_misses() const noexcept { return m_misses; }
+
+	private:
+		struct entry {
+			sdl::texture texture;
+			std::size_t last_used_frame;
+		};
+
+		// keyed on the font's id, a font reloaded at the same address must not hit the old textures
+		void make_key(const sdl::font& font, std::string_view text, const SDL_Color& color) {
+			auto font_id = font.get_id();
+			m_key.assign(reinterpret_cast<const char*>(&font_id), sizeof(font_id));
+			m_key.push_back(static_cast<char>(color.r));
+			m_key.push_back(static_cast<char>(color.g));
+			m_key.push_back(static_cast<char>(color.b));
+			m_key.push_back(static_cast<char>(color.a));
+			m_key.append(text);
+		}
+
+		[[nodiscard]] static std::uint32_t key_font_id(const std::string& key) noexcept {
+			std::uint32_t font_id;
+			std::memcpy(&font_id, key.data(), sizeof(font_id));
+			return font_id;
+		}
+
+		[[nodiscard]] const sdl::texture& get_empty(const sdl::renderer& renderer) {
+			if (!m_empty) {
+				const Uint32 transparent = 0;
+				m_empty = renderer.create_texture(SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 1, 1);
+				m_empty->update(&transparent, sizeof(transparent));
+				m_empty->set_blend_mode(SDL_BLENDMODE_BLEND);
+			}
+
+			return *m_empty;
+		}
+
+		std::unordered_map<std::string, entry> m_entries;
+		std::optional<sdl::texture> m_empty;
+		std::string m_key;
+		std::size_t m_frame = 0;
+		std::size_t m_max_idle_frames = default_max_idle_frames;
+		std::size_t m_hits = 0;
+		std::size_t m_misses = 0;
+	};
+}
@@ -1,42 +1,48 @@
 #pragma once
 #include <SDL.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include "errors.h"
 #include "surface.h"
 
 namespace sdl {
 	struct renderer;
 	struct texture;
+	struct sprite_batch;
+
+	// for target textures drawn with SDL_BLENDMODE_BLEND over a transparent clear. their colour is
+	// already multiplied by alpha, so copying them out must not multiply it again. it is a custom
+	// mode, see texture::set_blend_mode_or_blend for renderers that don't support those
+	[[nodiscard]] inline SDL_BlendMode premultiplied_blend_mode() noexcept {
+		return SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+			SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+	}
 
 	struct guard_texture_color_mod {
 
 		guard_texture_color_mod() = delete;
 		guard_texture_color_mod(const guard_texture_color_mod&) = delete;
 		guard_texture_color_mod(guard_texture_color_mod&& other) noexcept {
-			std::swap(m_texture_ptr, other.m_texture_ptr);
+			std::swap(m_texture, other.m_texture);
 			std::swap(m_original_color, other.m_original_color);
 		}
 
 		guard_texture_color_mod& operator=(const guard_texture_color_mod&) = delete;
 		guard_texture_color_mod& operator=(guard_texture_color_mod&& other) noexcept {
-			std::swap(m_texture_ptr, other.m_texture_ptr);
+			std::swap(m_texture, other.m_texture);
+			std::swap(m_original_color, other.m_original_color);
 			return *this;
 		}
 
-		~guard_texture_color_mod() {
-			if (m_texture_ptr != nullptr) {
-				SDL_SetTextureColorMod(m_texture_ptr, m_original_color.r, m_original_color.g, m_original_color.b);
-			}
-		}
+		~guard_texture_color_mod();
 
 	private:
 
-		explicit guard_texture_color_mod(SDL_Texture* p_texture_ptr) : m_texture_ptr{ p_texture_ptr } {
-			if (m_texture_ptr != nullptr) {
-				SDL_GetTextureColorMod(m_texture_ptr, &m_original_color.r, &m_original_color.g, &m_original_color.b);
-			}
-		}
+		explicit guard_texture_color_mod(const texture* p_texture);
 
-		SDL_Texture* m_texture_ptr{ nullptr };
+		const texture* m_texture{ nullptr };
 		SDL_Color m_original_color{ 0, 0, 0, 0 };
 
 		friend texture;
@@ -48,46 +54,94 @@ namespace sdl {
 		guard_texture_alpha_mod() = delete;
 		guard_texture_alpha_mod(const guard_texture_alpha_mod&) = delete;
 		guard_texture_alpha_mod(guard_texture_alpha_mod&& other) noexcept {
-			std::swap(m_texture_ptr, other.m_texture_ptr);
+			std::swap(m_texture, other.m_texture);
 			std::swap(m_original_alpha, other.m_original_alpha);
 		}
 
 		guard_texture_alpha_mod& operator=(const guard_texture_alpha_mod&) = delete;
 		guard_texture_alpha_mod& operator=(guard_texture_alpha_mod&& other) noexcept {
-			std::swap(m_texture_ptr, other.m_texture_ptr);
+			std::swap(m_texture, other.m_texture);
+			std::swap(m_original_alpha, other.m_original_alpha);
 			return *this;
 		}
 
-		~guard_texture_alpha_mod() {
-			if (m_texture_ptr != nullptr) {
-				SDL_SetTextureAlphaMod(m_texture_ptr, m_original_alpha);
-			}
-		}
+		~guard_texture_alpha_mod();
 
 	private:
-		explicit guard_texture_alpha_mod(SDL_Texture* p_texture_ptr) : m_texture_ptr{ p_texture_ptr } {
-			if (m_texture_ptr != nullptr) {
-				SDL_GetTextureAlphaMod(m_texture_ptr, &m_original_alpha);
-			}
-		}
+		explicit guard_texture_alpha_mod(const texture* p_texture);
 
-		SDL_Texture* m_texture_ptr{ nullptr };
+		const texture* m_texture{ nullptr };
 		uint8_t m_original_alpha{ 0 };
 
 		friend texture;
 	};
 
 
+	// pixels of a locked streaming texture, write-only; unlocks (and uploads) when destroyed
+	struct guard_texture_lock {
+
+		guard_texture_lock() = delete;
+		guard_texture_lock(const guard_texture_lock&) = delete;
+		guard_texture_lock(guard_texture_lock&& other) noexcept {
+			std::swap(m_texture, other.m_texture);
+			std::swap(m_pixels, other.m_pixels);
+			std::swap(m_pitch, other.m_pitch);
+			std::swap(m_width, other.m_width);
+			std::swap(m_height, other.m_height);
+		}
+
+		guard_texture_lock& operator=(const guard_texture_lock&) = delete;
+		guard_texture_lock& operator=(guard_texture_lock&& other) noexcept {
+			std::swap(m_texture, other.m_texture);
+			std::swap(m_pixels, other.m_pixels);
+			std::swap(m_pitch, other.m_pitch);
+			std::swap(m_width, other.m_width);
+			std::swap(m_height, other.m_height);
+			return *this;
+		}
+
+		~guard_texture_lock();
+
+		[[nodiscard]] void* get_pixels() const noexcept { return m_pixels; }
+		[[nodiscard]] int get_pitch() const noexcept { return m_pitch; }
+		[[nodiscard]] int get_width() const noexcept { return m_width; }
+		[[nodiscard]] int get_height() const noexcept { return m_height; }
+
+		[[nodiscard]] std::span<std::byte> get_bytes() const noexcept {
+			return { static_cast<std::byte*>(m_pixels), static_cast<std::size_t>(m_pitch) * static_cast<std::size_t>(m_height) };
+		}
+
+		// one row of the locked rect; Pixel has to match the texture format's size
+		template <typename Pixel = Uint32>
+		[[nodiscard]] std::span<Pixel> get_row(int y) const noexcept {
+			auto* row = static_cast<std::byte*>(m_pixels) + static_cast<std::ptrdiff_t>(y) * m_pitch;
+			return { reinterpret_cast<Pixel*>(row), static_cast<std::size_t>(m_width) };
+		}
+
+	private:
+		guard_texture_lock(const texture* p_texture, void* pixels, int pitch, int width, int height)
+			: m_texture{ p_texture }, m_pixels{ pixels }, m_pitch{ pitch }, m_width{ width }, m_height{ height } {}
+
+		const texture* m_texture{ nullptr };
+		void* m_pixels{ nullptr };
+		int m_pitch{ 0 };
+		int m_width{ 0 };
+		int m_height{ 0 };
+
+		friend texture;
+	};
+
+
 	struct texture {
 		texture() = default;
 		texture(const texture&) = delete;
 		texture(texture&& other) noexcept {
-			std::swap(m_texture_ptr, other.m_texture_ptr);
+			swap_state(other);
 		};
 
 		texture& operator=(const texture&) = delete;
 		texture& operator=(texture&& other) noexcept {
-			std::swap(m_texture_ptr, other.m_texture_ptr);
+			swap_state(other);
 			return *this;
 		}
 
@@ -101,32 +155,48 @@ namespace sdl {
 		//}
 
 		[[nodiscard]] SDL_BlendMode get_blend_mode() const {
-			SDL_BlendMode bm;
-			if (SDL_GetTextureBlendMode(m_texture_ptr, &bm) == -1) {
-				// TODO: throw error;
-			}
-			return bm;
+			return m_blend_mode;
 		}
 
 		void set_blend_mode(SDL_BlendMode blend_mode) const {
+			if (blend_mode == m_blend_mode) {
+				return;
+			}
+
 			if (SDL_SetTextureBlendMode(m_texture_ptr, blend_mode) == -1) {
 				// TODO: throw error;
+				return;
 			}
+			m_blend_mode = blend_mode;
+		}
+
+		// renderers without custom blend modes, the software one among them, reject modes made by
+		// SDL_ComposeCustomBlendMode. those fall back to SDL_BLENDMODE_BLEND, which for premultiplied
+		// content darkens translucent pixels. returns false when it had to fall back
+		bool set_blend_mode_or_blend(SDL_BlendMode blend_mode) const {
+			set_blend_mode(blend_mode);
+			if (m_blend_mode == blend_mode) {
+				return true;
+			}
+
+			set_blend_mode(SDL_BLENDMODE_BLEND);
+			return false;
 		}
 
 		void set_alpha_mod(uint8_t alpha) const {
+			if (alpha == m_alpha_mod) {
+				return;
+			}
+
 			if (SDL_SetTextureAlphaMod(m_texture_ptr, alpha) == -1) {
 				// TODO: throw error;
+				return;
 			}
+			m_alpha_mod = alpha;
 		}
 
 		[[nodiscard]] uint8_t get_alpha_mod() const {
-			uint8_t alpha;
-			if (SDL_GetTextureAlphaMod(m_texture_ptr, &alpha) == -1) {
-				// TODO: throw error;
-			}
-
-			return alpha;
+			return m_alpha_mod;
 		}
 
 		template <typename ColorValue = SDL_Color>
@@ -135,28 +205,49 @@ namespace sdl {
 		}
 
 		void set_color_mod(uint8_t r, uint8_t g, uint8_t b) const {
+			if (r == m_color_mod.r && g == m_color_mod.g && b == m_color_mod.b) {
+				return;
+			}
+
 			if (SDL_SetTextureColorMod(m_texture_ptr, r, g, b) == -1) {
 				// TODO: throw error;
+				return;
 			}
+			m_color_mod = { r, g, b, 255 };
 		}
 
 		template <typename ColorValue = SDL_Color>
 		[[nodiscard]] ColorValue get_color_mod() const {
-			uint8_t r, g, b;
-
-			if (SDL_GetTextureColorMod(m_texture_ptr, &r, &g, &b) == -1) {
-				// TODO: throw error;
-			}
-
-			return { r, g, b };
+			return { m_color_mod.r, m_color_mod.g, m_color_mod.b };
 		}
 
 		[[nodiscard]] guard_texture_color_mod get_color_mod_guard() const {
-			return guard_texture_color_mod(m_texture_ptr);
+			return guard_texture_color_mod(this);
 		}
 
 		[[nodiscard]] guard_texture_alpha_mod get_alpha_mod_guard() const {
-			return guard_texture_alpha_mod(m_texture_ptr);
+			return guard_texture_alpha_mod(this);
+		}
+
+		// only for textures created with SDL_TEXTUREACCESS_STREAMING
+		[[nodiscard]] guard_texture_lock lock() const {
+			return lock_impl(nullptr, m_width, m_height);
+		}
+
+		[[nodiscard]] guard_texture_lock lock(const SDL_Rect& rect) const {
+			return lock_impl(&rect, rect.w, rect.h);
+		}
+
+		void update(const void* pixels, int pitch) const {
+			if (SDL_UpdateTexture(m_texture_ptr, nullptr, pixels, pitch) == -1) {
+				throw texture_update_error();
+			}
+		}
+
+		void update(const SDL_Rect& rect, const void* pixels, int pitch) const {
+			if (SDL_UpdateTexture(m_texture_ptr, &rect, pixels, pitch) == -1) {
+				throw texture_update_error();
+			}
 		}
 
 		~texture() {
@@ -167,22 +258,112 @@ namespace sdl {
 
 		template<typename SizeType = std::pair<int, int>>
 		SizeType get_size() const {
-			int w, h;
-			if (SDL_QueryTexture(m_texture_ptr, nullptr, nullptr, &w, &h) == -1) {
+			if (m_texture_ptr == nullptr) {
 				throw invalid_texture_error();
 			}
 
-			return { w, h };
+			return { m_width, m_height };
+		}
+
+		[[nodiscard]] Uint32 get_format() const noexcept {
+			return m_format;
+		}
+
+		[[nodiscard]] int get_access() const noexcept {
+			return m_access;
+		}
+
+		[[nodiscard]] std::uint32_t get_id() const noexcept {
+			return m_id;
 		}
 
 	private:
-		explicit texture(SDL_Texture* texture) : m_texture_ptr(texture) {
+		explicit texture(SDL_Texture* texture) : m_texture_ptr(texture), m_id(next_id()) {
 			if (m_texture_ptr == nullptr) {
 				throw invalid_texture_error();
 			}
+
+			if (SDL_QueryTexture(m_texture_ptr, &m_format, &m_access, &m_width, &m_height) == -1) {
+				throw invalid_texture_error();
+			}
+
+			SDL_GetTextureBlendMode(m_texture_ptr, &m_blend_mode);
+			SDL_GetTextureColorMod(m_texture_ptr, &m_color_mod.r, &m_color_mod.g, &m_color_mod.b);
+			SDL_GetTextureAlphaMod(m_texture_ptr, &m_alpha_mod);
+		}
+
+		[[nodiscard]] guard_texture_lock lock_impl(const SDL_Rect* rect, int width, int height) const {
+			void* pixels = nullptr;
+			int pitch = 0;
+
+			if (SDL_LockTexture(m_texture_ptr, rect, &pixels, &pitch) == -1) {
+				throw texture_lock_error();
+			}
+
+			return guard_texture_lock(this, pixels, pitch, width, height);
+		}
+
+		[[nodiscard]] static std::uint32_t next_id() noexcept {
+			static std::atomic<std::uint32_t> counter{ 0 };
+			return ++counter;
+		}
+
+		void swap_state(texture& other) noexcept {
+			std::swap(m_texture_ptr, other.m_texture_ptr);
+			std::swap(m_id, other.m_id);
+			std::swap(m_format, other.m_format);
+			std::swap(m_access, other.m_access);
+			std::swap(m_width, other.m_width);
+			std::swap(m_height, other.m_height);
+			std::swap(m_blend_mode, other.m_blend_mode);
+			std::swap(m_color_mod, other.m_color_mod);
+			std::swap(m_alpha_mod, other.m_alpha_mod);
 		}
 
 		SDL_Texture* m_texture_ptr = nullptr;
+		std::uint32_t m_id = 0;
+
+		Uint32 m_format = 0;
+		int m_access = 0;
+		int m_width = 0;
+		int m_height = 0;
+
+		mutable SDL_BlendMode m_blend_mode = SDL_BLENDMODE_NONE;
+		mutable SDL_Color m_color_mod{ 255, 255, 255, 255 };
+		mutable uint8_t m_alpha_mod = 255;
+
 		friend renderer;
+		friend sprite_batch;
+		friend guard_texture_lock;
 	};
-}
\ No newline at end of file
+
+	inline guard_texture_color_mod::guard_texture_color_mod(const texture* p_texture) : m_texture{ p_texture } {
+		if (m_texture != nullptr) {
+			m_original_color = m_texture->get_color_mod();
+		}
+	}
+
+	inline guard_texture_color_mod::~guard_texture_color_mod() {
+		if (m_texture != nullptr) {
+			m_texture->set_color_mod(m_original_color);
+		}
+	}
+
+	inline guard_texture_alpha_mod::guard_texture_alpha_mod(const texture* p_texture) : m_texture{ p_texture } {
+		if (m_texture != nullptr) {
+			m_original_alpha = m_texture->get_alpha_mod();
+		}
+	}
+
+	inline guard_texture_alpha_mod::~guard_texture_alpha_mod() {
+		if (m_texture != nullptr) {
+			m_texture->set_alpha_mod(m_original_alpha);
+		}
+	}
+
+	inline guard_texture_lock::~guard_texture_lock() {
+		if (m_texture != nullptr) {
+			SDL_UnlockTexture(m_texture->m_texture_ptr);
+		}
+	}
+}
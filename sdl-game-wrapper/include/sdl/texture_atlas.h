@@ -0,0 +1,174 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include "errors.h"
+#include "surface.h"
+#include "texture.h"
+#include "renderer.h"
+#include "image_manager.h"
+#include "skyline_packer.h"
+
+namespace sgw {
+
+	enum class atlas_region : std::size_t {};
+
+	struct atlas_sprite {
+		const sdl::texture& texture;
+		SDL_Rect source;
+	};
+
+	struct texture_atlas {
+		static constexpr int default_page_size = 2048;
+		static constexpr int default_padding = 1;
+
+		texture_atlas() : texture_atlas(default_page_size, default_page_size, default_padding) {}
+		texture_atlas(int page_width, int page_height, int padding)
+			: m_page_width(page_width), m_page_height(page_height), m_padding(padding) {}
+
+		texture_atlas(const texture_atlas&) = delete;
+		texture_atlas(texture_atlas&&) noexcept = default;
+		texture_atlas& operator=(const texture_atlas&) = delete;
+		texture_atlas& operator=(texture_atlas&&) noexcept = default;
+		~texture_atlas() = default;
+
+		atlas_region add(const sdl::surface& surface) {
+			atlas_region region{ m_regions.size() };
+			m_regions.push_back({ 0, { 0, 0, surface.get_width(), surface.get_height() }, false });
+			m_pending.push_back({ region, &surface });
+			return region;
+		}
+
+		atlas_region add(const image_manager& images, image_resource image) {
+			return add(images.get_image(image));
+		}
+
+		void build(const sdl::renderer& renderer) {
+			std::sort(m_pending.begin(), m_pending.end(), [](const pending& a, const pending& b) {
+				return a.surface->get_height() > b.surface->get_height();
+			});
+
+			for (const auto& item : m_pending) {
+				auto& region = m_regions[static_cast<std::size_t>(item.region)];
+				auto [page_index, position] = allocate(region.rect.w, region.rect.h);
+
+				region.page = page_index;
+				region.rect.x = position.x;
+				region.rect.y = position.y;
+				region.packed = true;
+
+				auto& page = *m_pages[page_index];
+				blit(*item.surface, page.surface, region.rect);
+				page.dirty.push_back(region.rect);
+			}
+			m_pending.clear();
+
+			// a page's texture is uploaded whole once, after that only the regions blitted since
+			for (auto& page : m_pages) {
+				if (!page->has_texture) {
+					page->texture = renderer.create_texture(SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, page->surface.get_width(), page->surface.get_height());
+					page->texture.set_blend_mode(SDL_BLENDMODE_BLEND);
+					page->texture.update(page->surface.m_surface_ptr->pixels, page->surface.m_surface_ptr->pitch);
+					page->has_texture = true;
+				}
+				else {
+					for (const auto& rect : page->dirty) {
+						upload(*page, rect);
+					}
+				}
+				page->dirty.clear();
+			}
+		}
+
+		[[nodiscard]] atlas_sprite get(atlas_region region) const {
+			const auto& r = m_regions.at(static_cast<std::size_t>(region));
+			if (!r.packed) {
+				throw std::logic_error("atlas region has not been built yet");
+			}
+
+			return { m_pages[r.page]->texture, r.rect };
+		}
+
+		[[nodiscard]] std::size_t page_count() const noexcept { return m_pages.size(); }
+		[[nodiscard]] std::size_t region_count() const noexcept { return m_regions.size(); }
+		[[nodiscard]] const sdl::texture& get_page_texture(std::size_t page) const { return m_pages.at(page)->texture; }
+
+	private:
+		struct region_info {
+			std::size_t page;
+			SDL_Rect rect;
+			bool packed;
+		};
+
+		struct pending {
+			atlas_region region;
+			const sdl::surface* surface;
+		};
+
+		struct page {
+			sdl::surface surface;
+			skyline_packer packer;
+			sdl::texture texture;
+			std::vector<SDL_Rect> dirty;
+			bool has_texture = false;
+		};
+
+		[[nodiscard]] std::pair<std::size_t, SDL_Point> allocate(int w, int h) {
+			const auto padded_w = w + m_padding * 2;
+			const auto padded_h = h + m_padding * 2;
+
+			for (std::size_t i = 0; i < m_pages.size(); i++) {
+				if (auto rect = m_pages[i]->packer.insert(padded_w, padded_h)) {
+					return { i, { rect->x + m_padding, rect->y + m_padding } };
+				}
+			}
+
+			auto page_w = std::max(m_page_width, padded_w);
+			auto page_h = std::max(m_page_height, padded_h);
+			m_pages.push_back(std::make_unique<page>(page{
+				sdl::surface(SDL_CreateRGBSurfaceWithFormat(0, page_w, page_h, 32, SDL_PIXELFORMAT_RGBA32)),
+				skyline_packer(page_w, page_h),
+				sdl::texture(),
+				{},
+				false
+			}));
+
+			auto rect = m_pages.back()->packer.insert(padded_w, padded_h);
+			return { m_pages.size() - 1, { rect->x + m_padding, rect->y + m_padding } };
+		}
+
+		static void blit(const sdl::surface& source, const sdl::surface& destination, const SDL_Rect& rect) {
+			auto blend_mode = source.get_blend_mode();
+			source.set_blend_mode(SDL_BLENDMODE_NONE);
+
+			SDL_Rect dest = rect;
+			auto result = SDL_BlitSurface(source.m_surface_ptr, nullptr, destination.m_surface_ptr, &dest);
+			source.set_blend_mode(blend_mode);
+
+			if (result != 0) {
+				throw sdl::error();
+			}
+		}
+
+		static void upload(const page& target, const SDL_Rect& rect) {
+			const auto* surface = target.surface.m_surface_ptr;
+			const auto* pixels = static_cast<const std::uint8_t*>(surface->pixels)
+				+ static_cast<std::ptrdiff_t>(rect.y) * surface->pitch + static_cast<std::ptrdiff_t>(rect.x) * surface->format->BytesPerPixel;
+			target.texture.update(rect, pixels, surface->pitch);
+		}
+
+		int m_page_width;
+		int m_page_height;
+		int m_padding;
+
+		std::vector<region_info> m_regions;
+		std::vector<pending> m_pending;
+		// boxed so atlas_sprites and queued draws keep pointing at their page when another is added
+		std::vector<std::unique_ptr<page>> m_pages;
+	};
+}
@@ -0,0 +1,190 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "image_manager.h"
+#include "renderer.h"
+#include "resource_registry.h"
+#include "texture.h"
+
+namespace sgw {
+
+	// textures for image_manager images, uploaded on first use and evicted least recently used
+	// first once the estimated video memory passes the budget. textures used in the current
+	// frame are never evicted, so the budget can be exceeded for a frame
+	struct texture_cache {
+		static constexpr std::size_t default_budget_bytes = 256 * 1024 * 1024;
+
+		texture_cache(const sdl::renderer& renderer, image_manager& images, std::size_t budget_bytes = default_budget_bytes, bool drop_surfaces = false)
+			: m_renderer(renderer), m_images(images), m_budget_bytes(budget_bytes), m_drop_surfaces(drop_surfaces) {}
+
+		texture_cache(const texture_cache&) = delete;
+		texture_cache(texture_cache&&) = delete;
+		texture_cache& operator=(const texture_cache&) = delete;
+		texture_cache& operator=(texture_cache&&) = delete;
+		~texture_cache() = default;
+
+		[[nodiscard]] const sdl::texture& get(image_resource image) {
+			auto index = traits::index(image);
+			if (index >= m_entries.size()) {
+				m_entries.resize(index + 1);
+			}
+
+			auto& current = m_entries[index];
+			if (current.texture && current.image == image) {
+				m_hits++;
+				touch(index);
+				return *current.texture;
+			}
+
+			if (current.texture) {
+				evict(index);
+			}
+
+			current.texture = std::make_unique<sdl::texture>(m_renderer.create_texture_from_surface(m_images.ensure_image(image)));
+			current.image = image;
+			current.bytes = estimate_bytes(*current.texture);
+			m_used_bytes += current.bytes;
+			m_misses++;
+
+			if (m_drop_surfaces) {
+				m_images.drop_surface(image);
+			}
+
+			link_front(index);
+			current.last_used_frame = m_frame;
+			trim();
+
+			return *current.texture;
+		}
+
+		[[nodiscard]] bool contains(image_resource image) const noexcept {
+			auto index = traits::index(image);
+			return index < m_entries.size() && m_entries[index].texture && m_entries[index].image == image;
+		}
+
+		// call once the image was released from the image_manager
+		void remove(image_resource image) {
+			if (contains(image)) {
+				evict(traits::index(image));
+			}
+		}
+
+		void end_frame() {
+			m_frame++;
+			trim();
+		}
+
+		void clear() {
+			for (std::uint32_t index = 0; index < m_entries.size(); index++) {
+				if (m_entries[index].texture) {
+					evict(index);
+				}
+			}
+		}
+
+		void set_budget(std::size_t budget_bytes) {
+			m_budget_bytes = budget_bytes;
+			trim();
+		}
+
+		[[nodiscard]] std::size_t get_budget() const noexcept { return m_budget_bytes; }
+		[[nodiscard]] std::size_t get_used_bytes() const noexcept { return m_used_bytes; }
+		[[nodiscard]] std::size_t get_hits() const noexcept { return m_hits; }
+		[[nodiscard]] std::size_t get_misses() const noexcept { return m_misses; }
+		[[nodiscard]] std::size_t get_evictions() const noexcept { return m_evictions; }
+
+		[[nodiscard]] static std::size_t estimate_bytes(const sdl::texture& texture) {
+			auto [w, h] = texture.get_size();
+			auto bytes_per_pixel = SDL_BYTESPERPIXEL(texture.get_format());
+			return static_cast<std::size_t>(w) * static_cast<std::size_t>(h) * static_cast<std::size_t>(bytes_per_pixel != 0 ? bytes_per_pixel : 4);
+		}
+
+	private:
+		using traits = resource_handle_traits<image_resource>;
+		static constexpr std::uint32_t no_entry = traits::max_slots;
+
+		struct entry {
+			// boxed so growing m_entries doesn't move textures already handed out this frame
+			std::unique_ptr<sdl::texture> texture;
+			image_resource image{};
+			std::size_t bytes = 0;
+			std::size_t last_used_frame = 0;
+			std::uint32_t previous = no_entry;
+			std::uint32_t next = no_entry;
+		};
+
+		void touch(std::uint32_t index) {
+			m_entries[index].last_used_frame = m_frame;
+			if (m_head != index) {
+				unlink(index);
+				link_front(index);
+			}
+		}
+
+		void link_front(std::uint32_t index) {
+			auto& current = m_entries[index];
+			current.previous = no_entry;
+			current.next = m_head;
+
+			if (m_head != no_entry) {
+				m_entries[m_head].previous = index;
+			}
+			m_head = index;
+
+			if (m_tail == no_entry) {
+				m_tail = index;
+			}
+		}
+
+		void unlink(std::uint32_t index) {
+			auto& current = m_entries[index];
+
+			if (current.previous != no_entry) {
+				m_entries[current.previous].next = current.next;
+			}
+			else {
+				m_head = current.next;
+			}
+
+			if (current.next != no_entry) {
+				m_entries[current.next].previous = current.previous;
+			}
+			else {
+				m_tail = current.previous;
+			}
+
+			current.previous = no_entry;
+			current.next = no_entry;
+		}
+
+		void evict(std::uint32_t index) {
+			auto& current = m_entries[index];
+			unlink(index);
+			current.texture.reset();
+			m_used_bytes -= current.bytes;
+			current.bytes = 0;
+			m_evictions++;
+		}
+
+		void trim() {
+			while (m_used_bytes > m_budget_bytes && m_tail != no_entry && m_entries[m_tail].last_used_frame != m_frame) {
+				evict(m_tail);
+			}
+		}
+
+		const sdl::renderer& m_renderer;
+		image_manager& m_images;
+		std::vector<entry> m_entries;
+		std::uint32_t m_head = no_entry;
+		std::uint32_t m_tail = no_entry;
+		std::size_t m_budget_bytes;
+		std::size_t m_used_bytes = 0;
+		std::size_t m_frame = 0;
+		std::size_t m_hits = 0;
+		std::size_t m_misses = 0;
+		std::size_t m_evictions = 0;
+		bool m_drop_surfaces;
+	};
+}
@@ -1,3 +1,8 @@
 #pragma once
+#include "util/frame_arena.h"
 #include "util/math.h"
+#include "util/profiler.h"
 #include "util/random.h"
+#include "util/raycaster.h"
+#include "util/simd.h"
+#include "util/thread_pool.h"
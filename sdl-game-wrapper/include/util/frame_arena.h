@@ -0,0 +1,179 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "thread_pool.h"
+
+namespace sgw {
+
+	// bump allocator for data that lives at most one frame. deallocation is a no-op and reset()
+	// rewinds everything at once. when a frame overflowed into extra blocks, reset() replaces
+	// them with a single block of the combined size, so a steady workload stops touching the heap
+	struct frame_arena : std::pmr::memory_resource {
+		static constexpr std::size_t default_block_size = 1024 * 1024;
+
+		explicit frame_arena(std::size_t block_size = default_block_size, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+			: m_upstream(upstream) {
+			add_block(std::max<std::size_t>(block_size, alignof(std::max_align_t)));
+		}
+
+		frame_arena(const frame_arena&) = delete;
+		frame_arena(frame_arena&&) = delete;
+		frame_arena& operator=(const frame_arena&) = delete;
+		frame_arena& operator=(frame_arena&&) = delete;
+
+		~frame_arena() override {
+			for (auto& current : m_blocks) {
+				m_upstream->deallocate(current.data, current.size, alignof(std::max_align_t));
+			}
+		}
+
+		// everything allocated from the arena is invalid afterwards
+		void reset() {
+			m_high_water = std::max(m_high_water, m_used);
+			m_used = 0;
+			m_allocations = 0;
+
+			if (m_blocks.size() > 1) {
+				auto total = m_capacity;
+				for (auto& current : m_blocks) {
+					m_upstream->deallocate(current.data, current.size, alignof(std::max_align_t));
+				}
+				m_blocks.clear();
+				m_capacity = 0;
+				add_block(total);
+			}
+
+			m_offset = 0;
+		}
+
+		// bytes handed out since the last reset, including alignment padding
+		[[nodiscard]] std::size_t get_used() const noexcept { return m_used; }
+		[[nodiscard]] std::size_t get_high_water() const noexcept { return std::max(m_high_water, m_used); }
+		[[nodiscard]] std::size_t get_capacity() const noexcept { return m_capacity; }
+		[[nodiscard]] std::size_t get_allocation_count() const noexcept { return m_allocations; }
+		// blocks requested from upstream after construction; stays flat once the arena has warmed up
+		[[nodiscard]] std::size_t get_overflow_count() const noexcept { return m_overflows; }
+
+	protected:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+			auto* result = try_bump(bytes, alignment);
+			if (result == nullptr) {
+				add_block(std::max(m_blocks.back().size, bytes + alignment));
+				m_overflows++;
+				result = try_bump(bytes, alignment);
+			}
+
+			m_allocations++;
+			return result;
+		}
+
+		void do_deallocate(void* /*pointer*/, std::size_t /*bytes*/, std::size_t /*alignment*/) override {}
+
+		[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+
+	private:
+		struct block {
+			std::byte* data;
+			std::size_t size;
+		};
+
+		void* try_bump(std::size_t bytes, std::size_t alignment) noexcept {
+			const auto& current = m_blocks.back();
+			auto start = reinterpret_cast<std::uintptr_t>(current.data);
+			auto aligned = (start + m_offset + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+			auto end = aligned - start + bytes;
+
+			if (end > current.size) {
+				return nullptr;
+			}
+
+			m_used += end - m_offset;
+			m_offset = end;
+			return current.data + (aligned - start);
+		}
+
+		void add_block(std::size_t size) {
+			auto* data = static_cast<std::byte*>(m_upstream->allocate(size, alignof(std::max_align_t)));
+			m_blocks.push_back({ data, size });
+			m_capacity += size;
+			m_offset = 0;
+		}
+
+		std::pmr::memory_resource* m_upstream;
+		std::vector<block> m_blocks;
+		std::size_t m_offset = 0;
+		std::size_t m_capacity = 0;
+		std::size_t m_used = 0;
+		std::size_t m_high_water = 0;
+		std::size_t m_allocations = 0;
+		std::size_t m_overflows = 0;
+	};
+
+	template <typename T>
+	using frame_vector = std::pmr::vector<T>;
+	using frame_string = std::pmr::string;
+
+	// one arena per thread_pool worker plus one for the thread that owns the pool. only those
+	// threads may call local(); the asset loader threads are not covered
+	struct frame_arenas {
+
+		explicit frame_arenas(const thread_pool& pool, std::size_t block_size = frame_arena::default_block_size) : m_pool(pool) {
+			m_arenas.reserve(pool.size() + 1);
+			for (std::size_t i = 0; i <= pool.size(); i++) {
+				m_arenas.push_back(std::make_unique<frame_arena>(block_size));
+			}
+		}
+
+		frame_arenas(const frame_arenas&) = delete;
+		frame_arenas(frame_arenas&&) = delete;
+		frame_arenas& operator=(const frame_arenas&) = delete;
+		frame_arenas& operator=(frame_arenas&&) = delete;
+		~frame_arenas() = default;
+
+		[[nodiscard]] frame_arena& local() noexcept {
+			return *m_arenas[m_pool.current_worker()];
+		}
+
+		[[nodiscard]] frame_arena& main() noexcept {
+			return *m_arenas.back();
+		}
+
+		// only while no worker is using its arena, i.e. between frames
+		void reset() {
+			for (auto& arena : m_arenas) {
+				arena->reset();
+			}
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_arenas.size(); }
+		[[nodiscard]] const frame_arena& get(std::size_t index) const { return *m_arenas.at(index); }
+
+		[[nodiscard]] std::size_t get_high_water() const noexcept {
+			std::size_t total = 0;
+			for (const auto& arena : m_arenas) {
+				total += arena->get_high_water();
+			}
+			return total;
+		}
+
+		[[nodiscard]] std::size_t get_overflow_count() const noexcept {
+			std::size_t total = 0;
+			for (const auto& arena : m_arenas) {
+				total += arena->get_overflow_count();
+			}
+			return total;
+		}
+
+	private:
+		const thread_pool& m_pool;
+		std::vector<std::unique_ptr<frame_arena>> m_arenas;
+	};
+}
@@ -0,0 +1,319 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sgw::profiling {
+
+	using clock = std::chrono::steady_clock;
+
+	struct zone_record {
+		const char* name;
+		std::int64_t start_ns;
+		std::int64_t end_ns;
+		std::uint32_t depth;
+	};
+
+	struct thread_buffer {
+		static constexpr std::size_t default_capacity = 16384;
+
+		explicit thread_buffer(std::uint32_t thread_id, std::size_t capacity = default_capacity)
+			: m_slots(capacity), m_thread_id(thread_id) {}
+
+		void push(const char* name, std::int64_t start_ns, std::int64_t end_ns, std::uint32_t depth) noexcept {
+			auto index = m_write_index.load(std::memory_order_relaxed);
+			auto& slot = m_slots[index % m_slots.size()];
+
+			// pairs with the fence in snapshot, a reader that sees any of these stores also sees index
+			std::atomic_thread_fence(std::memory_order_release);
+			slot.name.store(name, std::memory_order_relaxed);
+			slot.start_ns.store(start_ns, std::memory_order_relaxed);
+			slot.end_ns.store(end_ns, std::memory_order_relaxed);
+			slot.depth.store(depth, std::memory_order_relaxed);
+
+			m_write_index.store(index + 1, std::memory_order_release);
+		}
+
+		// copies the records that were not overwritten while reading
+		void snapshot(std::vector<zone_record>& out) const {
+			const auto end = m_write_index.load(std::memory_order_acquire);
+			const auto capacity = m_slots.size();
+			const auto begin = end > capacity ? end - capacity : 0;
+			const auto first = out.size();
+
+			for (auto i = begin; i < end; i++) {
+				const auto& slot = m_slots[i % capacity];
+				out.push_back({
+					slot.name.load(std::memory_order_relaxed),
+					slot.start_ns.load(std::memory_order_relaxed),
+					slot.end_ns.load(std::memory_order_relaxed),
+					slot.depth.load(std::memory_order_relaxed)
+				});
+			}
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			const auto written_meanwhile = m_write_index.load(std::memory_order_acquire) - end;
+
+			// the slot the writer is filling right now may have been copied half written as well
+			const auto reached = end + written_meanwhile + 1;
+			const auto overwritten = reached > begin + capacity
+				? std::min<std::size_t>(reached - begin - capacity, out.size() - first)
+				: std::size_t{ 0 };
+			out.erase(out.begin() + static_cast<std::ptrdiff_t>(first), out.begin() + static_cast<std::ptrdiff_t>(first + overwritten));
+		}
+
+		[[nodiscard]] std::uint32_t get_thread_id() const noexcept { return m_thread_id; }
+		[[nodiscard]] const std::string& get_name() const noexcept { return m_name; }
+		void set_name(std::string name) { m_name = std::move(name); }
+
+		std::uint32_t depth = 0;
+
+	private:
+		struct slot {
+			std::atomic<const char*> name{ nullptr };
+			std::atomic<std::int64_t> start_ns{ 0 };
+			std::atomic<std::int64_t> end_ns{ 0 };
+			std::atomic<std::uint32_t> depth{ 0 };
+		};
+
+		std::vector<slot> m_slots;
+		std::atomic<std::size_t> m_write_index{ 0 };
+		std::uint32_t m_thread_id;
+		std::string m_name;
+	};
+
+	struct profiler {
+		profiler(const profiler&) = delete;
+		profiler(profiler&&) = delete;
+		profiler& operator=(const profiler&) = delete;
+		profiler& operator=(profiler&&) = delete;
+		~profiler() = default;
+
+		[[nodiscard]] static profiler& instance() {
+			static profiler p;
+			return p;
+		}
+
+		[[nodiscard]] bool is_enabled() const noexcept { return m_enabled.load(std::memory_order_relaxed); }
+		void set_enabled(bool enabled) noexcept { m_enabled.store(enabled, std::memory_order_relaxed); }
+
+		[[nodiscard]] std::int64_t now_ns() const noexcept {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - m_epoch).count();
+		}
+
+		[[nodiscard]] thread_buffer& local_buffer() {
+			thread_local thread_buffer* buffer = nullptr;
+
+			if (buffer == nullptr) {
+				std::lock_guard lock(m_mutex);
+				m_buffers.push_back(std::make_unique<thread_buffer>(static_cast<std::uint32_t>(m_buffers.size())));
+				buffer = m_buffers.back().get();
+			}
+
+			return *buffer;
+		}
+
+		void set_thread_name(std::string name) {
+			auto& buffer = local_buffer();
+			std::lock_guard lock(m_mutex);
+			buffer.set_name(std::move(name));
+		}
+
+		void write_chrome_trace(std::ostream& out) const {
+			std::vector<zone_record> records;
+			std::lock_guard lock(m_mutex);
+
+			const auto flags = out.flags();
+			const auto precision = out.precision();
+			out << std::fixed << std::setprecision(3);
+
+			out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+			bool first = true;
+
+			for (const auto& buffer : m_buffers) {
+				const auto tid = buffer->get_thread_id();
+
+				if (!buffer->get_name().empty()) {
+					out << (first ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":\"";
+					write_escaped(out, buffer->get_name());
+					out << "\"}}";
+					first = false;
+				}
+
+				records.clear();
+				buffer->snapshot(records);
+
+				for (const auto& record : records) {
+					if (record.name == nullptr) {
+						continue;
+					}
+
+					out << (first ? "" : ",") << "{\"name\":\"";
+					write_escaped(out, record.name);
+					out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+						<< ",\"ts\":" << static_cast<double>(record.start_ns) / 1000.0
+						<< ",\"dur\":" << static_cast<double>(record.end_ns - record.start_ns) / 1000.0 << "}";
+					first = false;
+				}
+			}
+
+			out << "]}";
+			out.flags(flags);
+			out.precision(precision);
+		}
+
+	private:
+		profiler() : m_epoch(clock::now()) {}
+
+		static void write_escaped(std::ostream& out, std::string_view text) {
+			for (auto c : text) {
+				if (c == '"' || c == '\\') {
+					out << '\\' << c;
+				}
+				else if (static_cast<unsigned char>(c) >= 0x20) {
+					out << c;
+				}
+			}
+		}
+
+		std::atomic<bool> m_enabled{ true };
+		clock::time_point m_epoch;
+		mutable std::mutex m_mutex;
+		std::vector<std::unique_ptr<thread_buffer>> m_buffers;
+	};
+
+	struct histogram {
+		static constexpr std::size_t default_window = 240;
+		static constexpr std::array<double, 8> bucket_limits_ms{ 0.5, 1.0, 2.0, 4.0, 8.0, 16.7, 33.3, 66.7 };
+
+		histogram() : histogram(default_window) {}
+		explicit histogram(std::size_t window) : m_samples(window, 0.0), m_scratch(window, 0.0) {}
+
+		void add(double milliseconds) noexcept {
+			auto& slot = m_samples[m_next % m_samples.size()];
+			if (m_next >= m_samples.size()) {
+				m_buckets[bucket_of(slot)]--;
+			}
+
+			slot = milliseconds;
+			m_buckets[bucket_of(milliseconds)]++;
+			m_next++;
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept { return std::min(m_next, m_samples.size()); }
+
+		[[nodiscard]] double last() const noexcept {
+			return m_next == 0 ? 0.0 : m_samples[(m_next - 1) % m_samples.size()];
+		}
+
+		[[nodiscard]] double mean() const noexcept {
+			auto count = size();
+			if (count == 0) {
+				return 0.0;
+			}
+
+			double sum = 0.0;
+			for (std::size_t i = 0; i < count; i++) {
+				sum += m_samples[i];
+			}
+			return sum / static_cast<double>(count);
+		}
+
+		[[nodiscard]] double max() const noexcept {
+			auto count = size();
+			return count == 0 ? 0.0 : *std::max_element(m_samples.begin(), m_samples.begin() + static_cast<std::ptrdiff_t>(count));
+		}
+
+		[[nodiscard]] double percentile(double p) {
+			auto count = size();
+			if (count == 0) {
+				return 0.0;
+			}
+
+			std::copy_n(m_samples.begin(), count, m_scratch.begin());
+			auto nth = static_cast<std::size_t>(std::clamp(p, 0.0, 1.0) * static_cast<double>(count - 1));
+			std::nth_element(m_scratch.begin(), m_scratch.begin() + static_cast<std::ptrdiff_t>(nth), m_scratch.begin() + static_cast<std::ptrdiff_t>(count));
+			return m_scratch[nth];
+		}
+
+		// counts per bucket, the last bucket collects everything above the final limit
+		[[nodiscard]] const std::array<std::size_t, bucket_limits_ms.size() + 1>& get_buckets() const noexcept { return m_buckets; }
+
+	private:
+		[[nodiscard]] static std::size_t bucket_of(double milliseconds) noexcept {
+			auto it = std::lower_bound(bucket_limits_ms.begin(), bucket_limits_ms.end(), milliseconds);
+			return static_cast<std::size_t>(it - bucket_limits_ms.begin());
+		}
+
+		std::vector<double> m_samples;
+		std::vector<double> m_scratch;
+		std::array<std::size_t, bucket_limits_ms.size() + 1> m_buckets{};
+		std::size_t m_next = 0;
+	};
+
+	struct frame_stats {
+		histogram frame;
+		histogram logic;
+		histogram events;
+		histogram draw;
+		histogram present;
+	};
+
+	struct scoped_zone {
+		explicit scoped_zone(const char* name, histogram* target = nullptr) : m_name(name), m_target(target) {
+			auto& p = profiler::instance();
+			if (!p.is_enabled()) {
+				m_name = nullptr;
+				return;
+			}
+
+			m_buffer = &p.local_buffer();
+			m_depth = m_buffer->depth++;
+			m_start_ns = p.now_ns();
+		}
+
+		scoped_zone(const scoped_zone&) = delete;
+		scoped_zone(scoped_zone&&) = delete;
+		scoped_zone& operator=(const scoped_zone&) = delete;
+		scoped_zone& operator=(scoped_zone&&) = delete;
+
+		~scoped_zone() {
+			if (m_name == nullptr) {
+				return;
+			}
+
+			const auto end_ns = profiler::instance().now_ns();
+			m_buffer->depth--;
+			m_buffer->push(m_name, m_start_ns, end_ns, m_depth);
+
+			if (m_target != nullptr) {
+				m_target->add(static_cast<double>(end_ns - m_start_ns) / 1e6);
+			}
+		}
+
+	private:
+		const char* m_name;
+		histogram* m_target;
+		thread_buffer* m_buffer = nullptr;
+		std::int64_t m_start_ns = 0;
+		std::uint32_t m_depth = 0;
+	};
+}
+
+#define SGW_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SGW_PROFILE_CONCAT(a, b) SGW_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef SGW_DISABLE_PROFILER
+#define SGW_PROFILE_ZONE(name)
+#else
+#define SGW_PROFILE_ZONE(name) ::sgw::profiling::scoped_zone SGW_PROFILE_CONCAT(sgw_profile_zone_, __LINE__){ name }
+#endif
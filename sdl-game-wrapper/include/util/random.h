@@ -1,4 +1,12 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <random>
 #include <type_traits>
 
@@ -11,87 +19,385 @@ namespace sgw::random {
 			: std::integral_constant<bool,
 				  std::is_floating_point_v<T> ||
 					  std::is_integral_v<T>> {};
+
+		template <typename RandomEngine>
+		struct engine_bits
+			: std::integral_constant<int,
+				  (RandomEngine::max() - RandomEngine::min()) == std::numeric_limits<std::uint64_t>::max() ? 64 :
+				  (RandomEngine::max() - RandomEngine::min()) == std::numeric_limits<std::uint32_t>::max() ? 32 : 0> {};
+
+		// seed() takes a 64 bit value without narrowing it
+		template <typename RandomEngine>
+		concept has_seed_u64 = requires(RandomEngine& engine, std::uint64_t value) { engine.seed({ value }); };
+
+		template <typename RandomEngine>
+		concept has_seed_sequence = requires(RandomEngine& engine, std::seed_seq& sequence) { engine.seed(sequence); };
+	}
+
+	// ============================================================================================================================
+
+	namespace detail {
+		[[nodiscard]] constexpr std::uint64_t rotl(std::uint64_t x, int k) noexcept {
+			return (x << k) | (x >> (64 - k));
+		}
+
+		[[nodiscard]] constexpr std::uint64_t splitmix64(std::uint64_t& state) noexcept {
+			auto z = (state += 0x9E3779B97F4A7C15ULL);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			return z ^ (z >> 31);
+		}
+
+		[[nodiscard]] inline std::uint64_t entropy_seed() {
+			std::random_device rd;
+			return (static_cast<std::uint64_t>(rd()) << 32) | rd();
+		}
+
+		inline std::atomic<std::uint64_t> base_seed{ entropy_seed() };
+		inline std::atomic<std::uint64_t> seed_generation{ 0 };
+		inline std::atomic<std::uint64_t> next_stream{ 0 };
+
+		// every thread draws its own stream from the base seed, in order of first use
+		[[nodiscard]] inline std::uint64_t next_thread_seed() noexcept {
+			std::uint64_t state = base_seed.load(std::memory_order_relaxed) + next_stream.fetch_add(1, std::memory_order_relaxed) * 0xD1B54A32D192ED03ULL;
+			return splitmix64(state);
+		}
 	}
 
 	// ============================================================================================================================
 
+	// xoshiro256** by Blackman and Vigna: 256 bits of state, passes BigCrush, a handful of cycles per value
+	struct xoshiro256ss {
+		using result_type = std::uint64_t;
+
+		static constexpr std::uint64_t default_seed = 0x853C49E6748FEA9BULL;
+
+		explicit constexpr xoshiro256ss(std::uint64_t value = default_seed) noexcept { seed(value); }
+
+		constexpr void seed(std::uint64_t value) noexcept {
+			for (auto& word : m_state) {
+				word = detail::splitmix64(value);
+			}
+		}
+
+		[[nodiscard]] static constexpr result_type min() noexcept { return 0; }
+		[[nodiscard]] static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+		constexpr result_type operator()() noexcept {
+			const auto result = detail::rotl(m_state[1] * 5, 7) * 9;
+			const auto t = m_state[1] << 17;
+
+			m_state[2] ^= m_state[0];
+			m_state[3] ^= m_state[1];
+			m_state[1] ^= m_state[2];
+			m_state[0] ^= m_state[3];
+			m_state[2] ^= t;
+			m_state[3] = detail::rotl(m_state[3], 45);
+
+			return result;
+		}
+
+	private:
+		std::array<std::uint64_t, 4> m_state{};
+	};
+
+	// pcg32 (XSH RR) by O'Neill: 64 bits of state, selectable stream
+	struct pcg32 {
+		using result_type = std::uint32_t;
+
+		static constexpr std::uint64_t default_seed = 0x853C49E6748FEA9BULL;
+		static constexpr std::uint64_t default_stream = 0xDA3E39CB94B95BDBULL;
+
+		explicit constexpr pcg32(std::uint64_t value = default_seed, std::uint64_t stream = default_stream) noexcept { seed(value, stream); }
+
+		constexpr void seed(std::uint64_t value, std::uint64_t stream = default_stream) noexcept {
+			m_state = 0;
+			m_increment = (stream << 1) | 1;
+			(*this)();
+			m_state += value;
+			(*this)();
+		}
+
+		[[nodiscard]] static constexpr result_type min() noexcept { return 0; }
+		[[nodiscard]] static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+		constexpr result_type operator()() noexcept {
+			const auto old = m_state;
+			m_state = old * 6364136223846793005ULL + m_increment;
+
+			const auto shifted = static_cast<std::uint32_t>(((old >> 18) ^ old) >> 27);
+			const auto rotation = static_cast<std::uint32_t>(old >> 59);
+			return (shifted >> rotation) | (shifted << ((32 - rotation) & 31));
+		}
+
+	private:
+		std::uint64_t m_state = 0;
+		std::uint64_t m_increment = 0;
+	};
+
+	using default_engine = xoshiro256ss;
+
+	// ============================================================================================================================
+
+	// four interleaved xoshiro256** streams with their state laid out per word, so the update
+	// loops map onto vector registers; used for bulk fills
+	struct xoshiro256ss_x4 {
+		static constexpr std::size_t lanes = 4;
+
+		template <typename Seeder>
+		explicit xoshiro256ss_x4(Seeder& seeder) {
+			for (auto& word : m_state) {
+				for (auto& lane : word) {
+					lane = seeder();
+				}
+			}
+		}
+
+		// count has to be a multiple of lanes; the state lives in locals for the whole loop
+		// so the compiler doesn't have to assume output aliases it
+		void generate(std::uint64_t* output, std::size_t count) noexcept {
+			auto s0 = m_state[0];
+			auto s1 = m_state[1];
+			auto s2 = m_state[2];
+			auto s3 = m_state[3];
+
+			for (std::size_t i = 0; i < count; i += lanes) {
+				for (std::size_t lane = 0; lane < lanes; lane++) {
+					output[i + lane] = detail::rotl(s1[lane] * 5, 7) * 9;
+
+					const auto t = s1[lane] << 17;
+					s2[lane] ^= s0[lane];
+					s3[lane] ^= s1[lane];
+					s1[lane] ^= s2[lane];
+					s0[lane] ^= s3[lane];
+					s2[lane] ^= t;
+					s3[lane] = detail::rotl(s3[lane], 45);
+				}
+			}
+
+			m_state = { s0, s1, s2, s3 };
+		}
+
+	private:
+		std::array<std::array<std::uint64_t, lanes>, 4> m_state{};
+	};
+
+	// ============================================================================================================================
+
 	template <typename RandomEngine>
 	struct random_impl {
+		static constexpr std::size_t bulk_threshold = 64;
 
-		template <typename T,
-			typename std::enable_if_t<std::is_integral_v<T>, int> = 0>
-		T next(const T& min, const T& max) {
-			return next_impl<T, std::uniform_int_distribution<T>>(min, max);
+		random_impl() : random_impl(detail::next_thread_seed()) {}
+		explicit random_impl(std::uint64_t value) {
+			seed(value);
 		}
 
-		template <typename T,
-			typename std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
-		T next(const T& min, const T& max) {
+		// the whole 64 bit value is used: passed through when seed() takes it, otherwise split into a
+		// seed_seq. std::mt19937 takes a 64 bit result_type on some platforms but keeps only 32 bits
+		// of it, so engines with fewer output bits prefer the seed_seq
+		void seed(std::uint64_t value) {
+			if constexpr (traits::has_seed_u64<RandomEngine> && (traits::engine_bits<RandomEngine>::value == 64 || !traits::has_seed_sequence<RandomEngine>)) {
+				generator.seed(value);
+			}
+			else if constexpr (traits::has_seed_sequence<RandomEngine>) {
+				std::seed_seq sequence{ static_cast<std::uint32_t>(value), static_cast<std::uint32_t>(value >> 32) };
+				generator.seed(sequence);
+			}
+			else {
+				generator.seed(static_cast<typename RandomEngine::result_type>(value));
+			}
+		}
 
-			return next_impl<T, std::uniform_real_distribution<T>>(min, max);
+		[[nodiscard]] std::uint64_t bits() {
+			if constexpr (traits::engine_bits<RandomEngine>::value == 64) {
+				return static_cast<std::uint64_t>(generator() - RandomEngine::min());
+			}
+			else if constexpr (traits::engine_bits<RandomEngine>::value == 32) {
+				auto high = static_cast<std::uint64_t>(generator() - RandomEngine::min());
+				auto low = static_cast<std::uint64_t>(generator() - RandomEngine::min());
+				return (high << 32) | low;
+			}
+			else {
+				return stitched_bits();
+			}
 		}
 
+		// callable as a 64 bit engine, e.g. to seed other generators
+		std::uint64_t operator()() { return bits(); }
+
 		template <typename T,
-			typename std::enable_if_t<std::is_same_v<T, char>, int> = 0>
+			typename std::enable_if_t<std::is_integral_v<T>, int> = 0>
 		T next(const T& min, const T& max) {
+			return from_bits(min, max, bits());
+		}
 
-			return static_cast<T>(next(static_cast<int>(min), static_cast<int>(max)));
+		template <typename T,
+			typename std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
+		T next(const T& min, const T& max) {
+			return from_bits(min, max, bits());
 		}
 
 		template <typename T, typename OutputIt,
-			typename std::enable_if_t<std::is_integral_v<T>, int> = 0>
+			typename std::enable_if_t<traits::is_valid_type_for_random<T>::value, int> = 0>
 		OutputIt range(const T& min, const T& max, std::size_t amount, OutputIt output) {
+			if constexpr (std::is_pointer_v<OutputIt> || std::contiguous_iterator<OutputIt>) {
+				using value_type = std::remove_cv_t<std::remove_reference_t<decltype(*output)>>;
+				if constexpr (std::is_same_v<value_type, T>) {
+					if (amount >= bulk_threshold) {
+						fill(std::to_address(output), amount, min, max);
+						return output + static_cast<std::ptrdiff_t>(amount);
+					}
+				}
+			}
+
+			for (std::size_t i = 0; i < amount; i++) {
+				*output++ = next(min, max);
+			}
 
-			return range_impl(min, max, amount, output);
+			return output;
 		}
 
-		template <typename T, typename OutputIt,
-			typename std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
-		OutputIt range(const T& min, const T& max, std::size_t amount, OutputIt output) {
+	private:
+		// engines with any other range (minstd_rand, ranlux24, ...) give up a power of two worth of
+		// bits per call; words from the uneven top of the range are redrawn, which the 8 spare bits
+		// keep rare
+		[[nodiscard]] std::uint64_t stitched_bits() {
+			constexpr auto range = static_cast<std::uint64_t>(RandomEngine::max() - RandomEngine::min()) + 1;
+			constexpr auto exact = std::has_single_bit(range);
+			constexpr auto word = exact ? static_cast<int>(std::bit_width(range)) - 1 : std::max(1, static_cast<int>(std::bit_width(range)) - 9);
+			constexpr auto word_mask = (std::uint64_t{ 1 } << word) - 1;
+			constexpr auto limit = exact ? range : range - range % (word_mask + 1);
+
+			std::uint64_t result = 0;
+			for (int filled = 0; filled < 64; filled += word) {
+				auto value = static_cast<std::uint64_t>(generator() - RandomEngine::min());
+				while (value >= limit) {
+					value = static_cast<std::uint64_t>(generator() - RandomEngine::min());
+				}
+
+				result = (result << word) | (value & word_mask);
+			}
 
-			return range_impl(min, max, amount, output);
+			return result;
 		}
 
-		template <typename T, typename OutputIt,
-			typename std::enable_if_t<std::is_same<T, char>::value, int> = 0>
-		OutputIt range(const T& min, const T& max, std::size_t amount, OutputIt output) {
+		template <typename T>
+		void fill(T* output, std::size_t amount, const T& min, const T& max) {
+			constexpr std::size_t chunk = 256;
+			xoshiro256ss_x4 lanes(*this);
+			std::array<std::uint64_t, chunk> raw{};
 
-			return range_impl(min, max, amount, output);
+			for (std::size_t i = 0; i < amount; i += chunk) {
+				const auto count = std::min(chunk, amount - i);
+				lanes.generate(raw.data(), (count + xoshiro256ss_x4::lanes - 1) / xoshiro256ss_x4::lanes * xoshiro256ss_x4::lanes);
+
+				for (std::size_t j = 0; j < count; j++) {
+					output[i + j] = from_bits(min, max, raw[j]);
+				}
+			}
 		}
 
-	private:
-		template <typename T, typename Dist>
-		T next_impl(const T& min, const T& max) {
+		template <typename T>
+		T from_bits(const T& min, const T& max, std::uint64_t raw) {
+			if constexpr (std::is_same_v<T, bool>) {
+				return min == max ? min : (raw >> 63) != 0;
+			}
+			else if constexpr (std::is_integral_v<T>) {
+				using unsigned_type = std::make_unsigned_t<T>;
+				auto span = static_cast<std::uint64_t>(static_cast<unsigned_type>(static_cast<unsigned_type>(max) - static_cast<unsigned_type>(min)));
+				return static_cast<T>(static_cast<unsigned_type>(static_cast<unsigned_type>(min) + static_cast<unsigned_type>(bounded(span, raw))));
+			}
+			else {
+				return min + (max - min) * unit<T>(raw);
+			}
+		}
 
-			Dist dis(min, max);
-			return dis(generator);
+		// uniform in [0, 1): the high bits become the mantissa of a number in [1, 2), which avoids
+		// integer to float conversions the vector units can't do
+		template <typename T>
+		[[nodiscard]] static T unit(std::uint64_t raw) noexcept {
+			if constexpr (std::is_same_v<T, float>) {
+				return std::bit_cast<float>(static_cast<std::uint32_t>(raw >> 41) | 0x3F800000U) - 1.F;
+			}
+			else {
+				return static_cast<T>(std::bit_cast<double>((raw >> 12) | 0x3FF0000000000000ULL) - 1.0);
+			}
 		}
 
-		template <typename T, typename OutputIt>
-		OutputIt range_impl(const T& min, const T& max, std::size_t amount, OutputIt output) {
+		// uniform in [0, span] without modulo bias; Lemire's multiply-shift for spans that
+		// fit in 32 bits, bitmask rejection above that. only draws again on rejection
+		std::uint64_t bounded(std::uint64_t span, std::uint64_t raw) {
+			if (span == std::numeric_limits<std::uint64_t>::max()) {
+				return raw;
+			}
+
+			const auto range = span + 1;
+			if (range <= (std::uint64_t{ 1 } << 32)) {
+				auto product = (raw >> 32) * range;
+				auto low = product & 0xFFFFFFFFULL;
 
-			for (std::size_t i = 0; i < amount; i++) {
-				*output++ = next(min, max);
+				if (low < range) {
+					const auto threshold = ((std::uint64_t{ 1 } << 32) - range) % range;
+					while (low < threshold) {
+						product = (bits() >> 32) * range;
+						low = product & 0xFFFFFFFFULL;
+					}
+				}
+
+				return product >> 32;
 			}
 
-			return output;
+			auto mask = span;
+			mask |= mask >> 1;
+			mask |= mask >> 2;
+			mask |= mask >> 4;
+			mask |= mask >> 8;
+			mask |= mask >> 16;
+			mask |= mask >> 32;
+
+			auto value = raw & mask;
+			while (value > span) {
+				value = bits() & mask;
+			}
+
+			return value;
 		}
 
-		std::random_device rd;
-		RandomEngine generator{ rd() };
+		RandomEngine generator;
 	};
 
-	template <typename RandomEngine = std::mt19937, typename T, typename std::enable_if_t<traits::is_valid_type_for_random<T>::value, int> = 0>
-	T next(const T& min, const T& max) {
-		static random_impl<RandomEngine> rg;
+	// ============================================================================================================================
 
-		return rg.next(min, max);
+	// makes every thread's generator restart from this seed; streams are handed out per thread in order of
+	// first use afterwards, so runs are reproducible as long as threads draw in a deterministic order
+	inline void seed(std::uint64_t value) noexcept {
+		detail::base_seed.store(value, std::memory_order_relaxed);
+		detail::next_stream.store(0, std::memory_order_relaxed);
+		detail::seed_generation.fetch_add(1, std::memory_order_release);
 	}
 
-	template <typename RandomEngine = std::mt19937, typename T, typename OutputIt, typename std::enable_if_t<traits::is_valid_type_for_random<T>::value, int> = 0>
-	OutputIt range(const T& min, const T& max, std::size_t amount, OutputIt output) {
-		static random_impl<RandomEngine> rg;
+	template <typename RandomEngine = default_engine>
+	[[nodiscard]] random_impl<RandomEngine>& thread_generator() {
+		thread_local random_impl<RandomEngine> rg;
+		thread_local std::uint64_t generation = detail::seed_generation.load(std::memory_order_acquire);
 
-		return rg.range(min, max, amount, output);
+		auto current = detail::seed_generation.load(std::memory_order_acquire);
+		if (current != generation) {
+			generation = current;
+			rg.seed(detail::next_thread_seed());
+		}
+
+		return rg;
+	}
+
+	template <typename RandomEngine = default_engine, typename T, typename std::enable_if_t<traits::is_valid_type_for_random<T>::value, int> = 0>
+	T next(const T& min, const T& max) {
+		return thread_generator<RandomEngine>().next(min, max);
+	}
+
+	template <typename RandomEngine = default_engine, typename T, typename OutputIt, typename std::enable_if_t<traits::is_valid_type_for_random<T>::value, int> = 0>
+	OutputIt range(const T& min, const T& max, std::size_t amount, OutputIt output) {
+		return thread_generator<RandomEngine>().range(min, max, amount, output);
 	}
-}
\ No newline at end of file
+}
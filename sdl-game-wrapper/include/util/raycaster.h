@@ -0,0 +1,474 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "simd.h"
+
+namespace sgw {
+
+	struct ray_hit {
+		static constexpr std::uint32_t no_segment = std::numeric_limits<std::uint32_t>::max();
+
+		glm::vec2 point{};
+		float distance = 0.F;
+		std::uint32_t segment = no_segment;
+
+		[[nodiscard]] bool is_hit() const noexcept { return segment != no_segment; }
+	};
+
+	// static line segments bucketed in a uniform grid. every cell keeps its own copy of the segments
+	// crossing it as padded SoA blocks, so a ray is tested against four segments per instruction.
+	// hits follow math::intersection: strictly inside the segment and strictly in front of the origin
+	struct raycaster {
+		static constexpr float default_cell_size = 64.F;
+		static constexpr std::size_t lanes = 4;
+		static constexpr std::size_t default_arc_steps = 32;
+
+		explicit raycaster(float cell_size = default_cell_size) : m_cell_size(cell_size), m_inverse_cell_size(1.F / cell_size) {}
+
+		raycaster(const raycaster&) = delete;
+		raycaster(raycaster&&) noexcept = default;
+		raycaster& operator=(const raycaster&) = delete;
+		raycaster& operator=(raycaster&&) noexcept = default;
+		~raycaster() = default;
+
+		std::uint32_t add_segment(const glm::vec2& p1, const glm::vec2& p2) {
+			m_segments.push_back({ p1, p2 });
+			m_dirty = true;
+			return static_cast<std::uint32_t>(m_segments.size() - 1);
+		}
+
+		void clear() {
+			m_segments.clear();
+			m_dirty = true;
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_segments.size(); }
+		[[nodiscard]] bool is_built() const noexcept { return !m_dirty; }
+
+		// bumped on every rebuild, lets caches detect geometry changes
+		[[nodiscard]] std::size_t get_version() const noexcept { return m_version; }
+
+		[[nodiscard]] std::pair<glm::vec2, glm::vec2> get_segment(std::uint32_t index) const {
+			return { m_segments[index].p1, m_segments[index].p2 };
+		}
+
+		// queries are const and read only the built grid, so they can run from several threads
+		void build() {
+			if (!m_dirty) {
+				return;
+			}
+
+			m_offsets.clear();
+			m_x1.clear();
+			m_y1.clear();
+			m_ex.clear();
+			m_ey.clear();
+			m_ids.clear();
+
+			m_dirty = false;
+			m_version++;
+
+			if (m_segments.empty()) {
+				m_columns = 0;
+				m_rows = 0;
+				return;
+			}
+
+			m_min = m_segments.front().p1;
+			glm::vec2 max = m_min;
+			for (const auto& segment : m_segments) {
+				m_min = glm::min(m_min, glm::min(segment.p1, segment.p2));
+				max = glm::max(max, glm::max(segment.p1, segment.p2));
+			}
+
+			m_columns = static_cast<int>((max.x - m_min.x) * m_inverse_cell_size) + 1;
+			m_rows = static_cast<int>((max.y - m_min.y) * m_inverse_cell_size) + 1;
+
+			std::vector<std::vector<std::uint32_t>> buckets(static_cast<std::size_t>(m_columns) * static_cast<std::size_t>(m_rows));
+			for (std::uint32_t index = 0; index < m_segments.size(); index++) {
+				const auto& segment = m_segments[index];
+				auto low = glm::min(segment.p1, segment.p2);
+				auto high = glm::max(segment.p1, segment.p2);
+
+				for (auto y = cell_y(low.y); y <= cell_y(high.y); y++) {
+					for (auto x = cell_x(low.x); x <= cell_x(high.x); x++) {
+						if (crosses_cell(segment, x, y)) {
+							buckets[cell_index(x, y)].push_back(index);
+						}
+					}
+				}
+			}
+
+			m_offsets.reserve(buckets.size() + 1);
+			for (const auto& bucket : buckets) {
+				m_offsets.push_back(static_cast<std::uint32_t>(m_ids.size()));
+
+				for (auto index : bucket) {
+					const auto& segment = m_segments[index];
+					m_x1.push_back(segment.p1.x);
+					m_y1.push_back(segment.p1.y);
+					m_ex.push_back(segment.p2.x - segment.p1.x);
+					m_ey.push_back(segment.p2.y - segment.p1.y);
+					m_ids.push_back(index);
+				}
+
+				// degenerate padding never intersects (zero denominator)
+				while (m_ids.size() % lanes != 0) {
+					m_x1.push_back(0.F);
+					m_y1.push_back(0.F);
+					m_ex.push_back(0.F);
+					m_ey.push_back(0.F);
+					m_ids.push_back(ray_hit::no_segment);
+				}
+			}
+			m_offsets.push_back(static_cast<std::uint32_t>(m_ids.size()));
+		}
+
+		[[nodiscard]] std::optional<ray_hit> cast(const glm::vec2& origin, const glm::vec2& direction, float max_distance = std::numeric_limits<float>::infinity()) const {
+			auto length = glm::length(direction);
+			if (length == 0.F || m_columns == 0) {
+				return std::nullopt;
+			}
+
+			const auto dir = direction / length;
+			auto best = max_distance;
+			auto best_id = ray_hit::no_segment;
+
+			walk_cells(origin, dir, max_distance, [&](std::size_t cell, float exit_distance) {
+				nearest_in_cell(cell, origin, dir, best, best_id);
+				return !(best_id != ray_hit::no_segment && best <= exit_distance);
+			});
+
+			if (best_id == ray_hit::no_segment) {
+				return std::nullopt;
+			}
+
+			return ray_hit{ origin + dir * best, best, best_id };
+		}
+
+		// misses are reported at max_distance along the ray with segment == no_segment
+		void cast_batch(const glm::vec2& origin, const glm::vec2* directions, std::size_t count, float max_distance, ray_hit* hits) const {
+			for (std::size_t i = 0; i < count; i++) {
+				if (auto hit = cast(origin, directions[i], max_distance)) {
+					hits[i] = *hit;
+				}
+				else {
+					auto length = glm::length(directions[i]);
+					auto dir = length != 0.F ? directions[i] / length : directions[i];
+					hits[i] = { origin + dir * max_distance, max_distance, ray_hit::no_segment };
+				}
+			}
+		}
+
+		// visible region around origin as a fan of points sorted by angle, clipped to radius
+		void visibility_polygon(const glm::vec2& origin, float radius, std::vector<glm::vec2>& polygon, std::size_t arc_steps = default_arc_steps) const {
+			constexpr float angle_epsilon = 0.0001F;
+			constexpr float two_pi = 6.28318530717958647692F;
+
+			std::vector<float> angles;
+			angles.reserve(arc_steps);
+			for (std::size_t i = 0; i < arc_steps; i++) {
+				angles.push_back(two_pi * static_cast<float>(i) / static_cast<float>(arc_steps));
+			}
+
+			const auto radius_squared = radius * radius;
+			for_each_segment_near(origin, radius, [&](std::uint32_t index) {
+				for (const auto& point : { m_segments[index].p1, m_segments[index].p2 }) {
+					auto offset = point - origin;
+					if (glm::dot(offset, offset) > radius_squared) {
+						continue;
+					}
+
+					auto angle = std::atan2(offset.y, offset.x);
+					angles.push_back(angle - angle_epsilon);
+					angles.push_back(angle);
+					angles.push_back(angle + angle_epsilon);
+				}
+			});
+
+			for (auto& angle : angles) {
+				angle = angle < 0.F ? angle + two_pi : angle;
+			}
+			std::sort(angles.begin(), angles.end());
+
+			std::vector<glm::vec2> directions;
+			directions.reserve(angles.size());
+			for (auto angle : angles) {
+				directions.emplace_back(std::cos(angle), std::sin(angle));
+			}
+
+			std::vector<ray_hit> hits(directions.size());
+			cast_batch(origin, directions.data(), directions.size(), radius, hits.data());
+
+			polygon.clear();
+			polygon.reserve(hits.size());
+			for (const auto& hit : hits) {
+				polygon.push_back(hit.point);
+			}
+		}
+
+	private:
+		struct segment {
+			glm::vec2 p1;
+			glm::vec2 p2;
+		};
+
+		[[nodiscard]] int cell_x(float x) const noexcept {
+			return std::clamp(static_cast<int>(std::floor((x - m_min.x) * m_inverse_cell_size)), 0, m_columns - 1);
+		}
+
+		[[nodiscard]] int cell_y(float y) const noexcept {
+			return std::clamp(static_cast<int>(std::floor((y - m_min.y) * m_inverse_cell_size)), 0, m_rows - 1);
+		}
+
+		[[nodiscard]] std::size_t cell_index(int x, int y) const noexcept {
+			return static_cast<std::size_t>(y) * static_cast<std::size_t>(m_columns) + static_cast<std::size_t>(x);
+		}
+
+		// separating axis test of the segment line against the cell box; the box already overlaps the segment bounds
+		[[nodiscard]] bool crosses_cell(const segment& current, int x, int y) const noexcept {
+			glm::vec2 low{ m_min.x + static_cast<float>(x) * m_cell_size, m_min.y + static_cast<float>(y) * m_cell_size };
+			auto high = low + m_cell_size;
+			auto edge = current.p2 - current.p1;
+
+			auto side = [&](float px, float py) { return edge.x * (py - current.p1.y) - edge.y * (px - current.p1.x); };
+			auto a = side(low.x, low.y);
+			auto b = side(high.x, low.y);
+			auto c = side(low.x, high.y);
+			auto d = side(high.x, high.y);
+
+			return !((a > 0 && b > 0 && c > 0 && d > 0) || (a < 0 && b < 0 && c < 0 && d < 0));
+		}
+
+		template <typename Func>
+		void for_each_segment_near(const glm::vec2& origin, float radius, Func func) const {
+			if (m_columns == 0) {
+				return;
+			}
+
+			std::vector<std::uint32_t> found;
+			for (auto y = cell_y(origin.y - radius); y <= cell_y(origin.y + radius); y++) {
+				for (auto x = cell_x(origin.x - radius); x <= cell_x(origin.x + radius); x++) {
+					auto cell = cell_index(x, y);
+					for (auto i = m_offsets[cell]; i < m_offsets[cell + 1]; i++) {
+						if (m_ids[i] != ray_hit::no_segment) {
+							found.push_back(m_ids[i]);
+						}
+					}
+				}
+			}
+
+			std::sort(found.begin(), found.end());
+			found.erase(std::unique(found.begin(), found.end()), found.end());
+			for (auto index : found) {
+				func(index);
+			}
+		}
+
+		// grid dda; visit(cell, exit_distance) returns false to stop
+		template <typename Visit>
+		void walk_cells(const glm::vec2& origin, const glm::vec2& dir, float max_distance, Visit visit) const {
+			constexpr auto infinity = std::numeric_limits<float>::infinity();
+			glm::vec2 grid_max{ m_min.x + static_cast<float>(m_columns) * m_cell_size, m_min.y + static_cast<float>(m_rows) * m_cell_size };
+
+			// clip the ray against the grid bounds
+			auto enter = 0.F;
+			auto leave = max_distance;
+			for (int axis = 0; axis < 2; axis++) {
+				if (dir[axis] == 0.F) {
+					if (origin[axis] < m_min[axis] || origin[axis] > grid_max[axis]) {
+						return;
+					}
+					continue;
+				}
+
+				auto t1 = (m_min[axis] - origin[axis]) / dir[axis];
+				auto t2 = (grid_max[axis] - origin[axis]) / dir[axis];
+				enter = std::max(enter, std::min(t1, t2));
+				leave = std::min(leave, std::max(t1, t2));
+			}
+
+			if (enter > leave) {
+				return;
+			}
+
+			auto start = origin + dir * enter;
+			auto x = cell_x(start.x);
+			auto y = cell_y(start.y);
+			const int step_x = dir.x > 0 ? 1 : -1;
+			const int step_y = dir.y > 0 ? 1 : -1;
+
+			const auto delta_x = dir.x != 0.F ? std::abs(m_cell_size / dir.x) : infinity;
+			const auto delta_y = dir.y != 0.F ? std::abs(m_cell_size / dir.y) : infinity;
+			auto boundary_x = m_min.x + static_cast<float>(step_x > 0 ? x + 1 : x) * m_cell_size;
+			auto boundary_y = m_min.y + static_cast<float>(step_y > 0 ? y + 1 : y) * m_cell_size;
+			auto next_x = dir.x != 0.F ? (boundary_x - origin.x) / dir.x : infinity;
+			auto next_y = dir.y != 0.F ? (boundary_y - origin.y) / dir.y : infinity;
+
+			while (x >= 0 && y >= 0 && x < m_columns && y < m_rows) {
+				auto exit_distance = std::min(next_x, next_y);
+				if (!visit(cell_index(x, y), exit_distance) || exit_distance > leave) {
+					return;
+				}
+
+				if (next_x < next_y) {
+					next_x += delta_x;
+					x += step_x;
+				}
+				else {
+					next_y += delta_y;
+					y += step_y;
+				}
+			}
+		}
+
+		// same terms as math::intersection with p3 = origin and p4 = origin + dir:
+		// den = ex * dy - ey * dx, t = ((y1 - oy) * dx - (x1 - ox) * dy) / den, u = (ex * (y1 - oy) - ey * (x1 - ox)) / den
+		void nearest_in_cell(std::size_t cell, const glm::vec2& origin, const glm::vec2& dir, float& best, std::uint32_t& best_id) const {
+			auto begin = m_offsets[cell];
+			auto end = m_offsets[cell + 1];
+
+#if defined(SGW_SIMD_SSE2)
+			const auto ox = _mm_set1_ps(origin.x);
+			const auto oy = _mm_set1_ps(origin.y);
+			const auto dx = _mm_set1_ps(dir.x);
+			const auto dy = _mm_set1_ps(dir.y);
+			const auto zero = _mm_setzero_ps();
+			const auto one = _mm_set1_ps(1.F);
+
+			for (auto i = begin; i < end; i += lanes) {
+				auto rx = _mm_sub_ps(_mm_loadu_ps(m_x1.data() + i), ox);
+				auto ry = _mm_sub_ps(_mm_loadu_ps(m_y1.data() + i), oy);
+				auto ex = _mm_loadu_ps(m_ex.data() + i);
+				auto ey = _mm_loadu_ps(m_ey.data() + i);
+
+				auto den = _mm_sub_ps(_mm_mul_ps(ex, dy), _mm_mul_ps(ey, dx));
+				auto t = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(ry, dx), _mm_mul_ps(rx, dy)), den);
+				auto u = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(ex, ry), _mm_mul_ps(ey, rx)), den);
+
+				auto valid = _mm_and_ps(_mm_cmpneq_ps(den, zero), _mm_and_ps(_mm_cmpgt_ps(t, zero), _mm_cmplt_ps(t, one)));
+				valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpgt_ps(u, zero), _mm_cmplt_ps(u, _mm_set1_ps(best))));
+
+				auto mask = _mm_movemask_ps(valid);
+				if (mask == 0) {
+					continue;
+				}
+
+				alignas(16) float distances[lanes];
+				_mm_store_ps(distances, u);
+				for (std::size_t lane = 0; lane < lanes; lane++) {
+					if ((mask & (1 << lane)) != 0 && distances[lane] < best) {
+						best = distances[lane];
+						best_id = m_ids[i + lane];
+					}
+				}
+			}
+#else
+			for (auto i = begin; i < end; i++) {
+				auto rx = m_x1[i] - origin.x;
+				auto ry = m_y1[i] - origin.y;
+				auto den = m_ex[i] * dir.y - m_ey[i] * dir.x;
+				if (den == 0.F) {
+					continue;
+				}
+
+				auto t = (ry * dir.x - rx * dir.y) / den;
+				auto u = (m_ex[i] * ry - m_ey[i] * rx) / den;
+				if (t > 0.F && t < 1.F && u > 0.F && u < best) {
+					best = u;
+					best_id = m_ids[i];
+				}
+			}
+#endif
+		}
+
+		float m_cell_size;
+		float m_inverse_cell_size;
+		std::vector<segment> m_segments;
+		bool m_dirty = false;
+		std::size_t m_version = 0;
+
+		glm::vec2 m_min{};
+		int m_columns = 0;
+		int m_rows = 0;
+		std::vector<std::uint32_t> m_offsets;
+		std::vector<float> m_x1;
+		std::vector<float> m_y1;
+		std::vector<float> m_ex;
+		std::vector<float> m_ey;
+		std::vector<std::uint32_t> m_ids;
+	};
+
+	// visibility polygons per light, recomputed only when the light moves or the geometry is rebuilt
+	struct visibility_cache {
+		static constexpr std::size_t default_max_idle_frames = 120;
+
+		visibility_cache() = default;
+		explicit visibility_cache(std::size_t max_idle_frames) : m_max_idle_frames(max_idle_frames) {}
+		visibility_cache(const visibility_cache&) = delete;
+		visibility_cache(visibility_cache&&) noexcept = default;
+		visibility_cache& operator=(const visibility_cache&) = delete;
+		visibility_cache& operator=(visibility_cache&&) noexcept = default;
+		~visibility_cache() = default;
+
+		[[nodiscard]] const std::vector<glm::vec2>& get(const raycaster& geometry, std::uint64_t light_id, const glm::vec2& origin, float radius) {
+			auto& current = m_entries[light_id];
+			if (current.version != geometry.get_version() || current.origin != origin || current.radius != radius || current.polygon.empty()) {
+				geometry.visibility_polygon(origin, radius, current.polygon);
+				current.version = geometry.get_version();
+				current.origin = origin;
+				current.radius = radius;
+				m_misses++;
+			}
+			else {
+				m_hits++;
+			}
+
+			current.last_used_frame = m_frame;
+			return current.polygon;
+		}
+
+		void end_frame() {
+			m_frame++;
+
+			for (auto it = m_entries.begin(); it != m_entries.end();) {
+				if (m_frame - it->second.last_used_frame > m_max_idle_frames) {
+					it = m_entries.erase(it);
+				}
+				else {
+					++it;
+				}
+			}
+		}
+
+		void clear() {
+			m_entries.clear();
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_entries.size(); }
+		[[nodiscard]] std::size_t get_hits() const noexcept { return m_hits; }
+		[[nodiscard]] std::size_t get_misses() const noexcept { return m_misses; }
+
+	private:
+		struct entry {
+			std::vector<glm::vec2> polygon;
+			glm::vec2 origin{};
+			float radius = 0.F;
+			std::size_t version = 0;
+			std::size_t last_used_frame = 0;
+		};
+
+		std::unordered_map<std::uint64_t, entry> m_entries;
+		std::size_t m_frame = 0;
+		std::size_t m_max_idle_frames = default_max_idle_frames;
+		std::size_t m_hits = 0;
+		std::size_t m_misses = 0;
+	};
+}
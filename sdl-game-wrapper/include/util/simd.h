@@ -0,0 +1,13 @@
+#pragma once
+
+// compile time instruction set selection shared by the batch kernels;
+// define SGW_DISABLE_SIMD to force the scalar paths
+#if !defined(SGW_DISABLE_SIMD) && defined(__AVX__)
+#define SGW_SIMD_AVX 1
+#include <immintrin.h>
+#endif
+
+#if !defined(SGW_DISABLE_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SGW_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
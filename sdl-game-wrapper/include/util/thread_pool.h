@@ -0,0 +1,245 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sgw {
+
+	struct task_group {
+		task_group() = default;
+		task_group(const task_group&) = delete;
+		task_group(task_group&&) = delete;
+		task_group& operator=(const task_group&) = delete;
+		task_group& operator=(task_group&&) = delete;
+		~task_group() = default;
+
+		[[nodiscard]] bool is_done() const noexcept { return m_pending.load(std::memory_order_acquire) == 0; }
+
+	private:
+		// keeps the first exception thrown by one of the group's tasks for wait() to rethrow
+		void set_error(std::exception_ptr error) {
+			std::lock_guard lock(m_error_mutex);
+			if (!m_error) {
+				m_error = std::move(error);
+			}
+		}
+
+		std::atomic<std::size_t> m_pending{ 0 };
+		std::mutex m_error_mutex;
+		std::exception_ptr m_error;
+		friend struct thread_pool;
+	};
+
+	struct thread_pool {
+		using task = std::function<void()>;
+
+		thread_pool() : thread_pool(0) {}
+		explicit thread_pool(std::size_t thread_count) {
+			if (thread_count == 0) {
+				auto hardware = std::thread::hardware_concurrency();
+				thread_count = hardware > 1 ? hardware - 1 : 1;
+			}
+
+			m_queues.reserve(thread_count);
+			for (std::size_t i = 0; i < thread_count; i++) {
+				m_queues.push_back(std::make_unique<queue>());
+			}
+
+			m_workers.reserve(thread_count);
+			for (std::size_t i = 0; i < thread_count; i++) {
+				m_workers.emplace_back([this, i]() { worker_loop(i); });
+			}
+		}
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool(thread_pool&&) = delete;
+		thread_pool& operator=(const thread_pool&) = delete;
+		thread_pool& operator=(thread_pool&&) = delete;
+
+		~thread_pool() {
+			{
+				std::lock_guard lock(m_sleep_mutex);
+				m_stopping = true;
+			}
+			m_sleep_cv.notify_all();
+
+			for (auto& worker : m_workers) {
+				worker.join();
+			}
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_workers.size(); }
+
+		// index of the calling worker, or size() when called from outside the pool
+		[[nodiscard]] std::size_t current_worker() const noexcept {
+			return t_owner == this ? t_worker_index : size();
+		}
+
+		void submit(task_group& group, task work) {
+			group.m_pending.fetch_add(1, std::memory_order_acq_rel);
+
+			push([&group, work = std::move(work)]() {
+				struct completion {
+					task_group& group;
+					~completion() { group.m_pending.fetch_sub(1, std::memory_order_acq_rel); }
+				} done{ group };
+
+				try {
+					work();
+				}
+				catch (...) {
+					group.set_error(std::current_exception());
+				}
+			});
+		}
+
+		// runs queued tasks on the calling thread until the group has finished, then rethrows the
+		// first exception one of its tasks threw
+		void wait(task_group& group) {
+			drain(group);
+
+			if (group.m_error) {
+				std::rethrow_exception(std::exchange(group.m_error, nullptr));
+			}
+		}
+
+		template <typename Func>
+		void parallel_for(std::size_t count, std::size_t chunk_size, Func func) {
+			if (count == 0) {
+				return;
+			}
+
+			chunk_size = std::max<std::size_t>(1, chunk_size);
+			if (count <= chunk_size) {
+				func(std::size_t{ 0 }, count);
+				return;
+			}
+
+			task_group group;
+			for (std::size_t begin = chunk_size; begin < count; begin += chunk_size) {
+				auto end = std::min(count, begin + chunk_size);
+				submit(group, [&func, begin, end]() { func(begin, end); });
+			}
+
+			// the submitted chunks reference func, so they have to finish before an exception leaves
+			try {
+				func(std::size_t{ 0 }, chunk_size);
+			}
+			catch (...) {
+				drain(group);
+				throw;
+			}
+
+			wait(group);
+		}
+
+	private:
+		struct queue {
+			std::mutex mutex;
+			std::deque<task> tasks;
+		};
+
+		void drain(task_group& group) {
+			while (!group.is_done()) {
+				if (auto work = pop(current_worker())) {
+					(*work)();
+				}
+				else {
+					std::this_thread::yield();
+				}
+			}
+		}
+
+		void push(task work) {
+			auto index = current_worker();
+			if (index == size()) {
+				index = m_next_queue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+			}
+
+			{
+				std::lock_guard lock(m_queues[index]->mutex);
+				m_queues[index]->tasks.push_back(std::move(work));
+			}
+
+			{
+				std::lock_guard lock(m_sleep_mutex);
+				m_queued.fetch_add(1, std::memory_order_release);
+			}
+			m_sleep_cv.notify_one();
+		}
+
+		std::optional<task> pop(std::size_t self) {
+			if (m_queued.load(std::memory_order_acquire) == 0) {
+				return std::nullopt;
+			}
+
+			// own queue from the back (most recently pushed, still hot in cache)
+			if (self < m_queues.size()) {
+				std::lock_guard lock(m_queues[self]->mutex);
+				auto& tasks = m_queues[self]->tasks;
+				if (!tasks.empty()) {
+					auto work = std::move(tasks.back());
+					tasks.pop_back();
+					m_queued.fetch_sub(1, std::memory_order_acq_rel);
+					return work;
+				}
+			}
+
+			// steal the oldest task from another queue
+			for (std::size_t offset = 1; offset <= m_queues.size(); offset++) {
+				auto victim = (self + offset) % m_queues.size();
+				std::lock_guard lock(m_queues[victim]->mutex);
+				auto& tasks = m_queues[victim]->tasks;
+				if (!tasks.empty()) {
+					auto work = std::move(tasks.front());
+					tasks.pop_front();
+					m_queued.fetch_sub(1, std::memory_order_acq_rel);
+					return work;
+				}
+			}
+
+			return std::nullopt;
+		}
+
+		void worker_loop(std::size_t index) {
+			t_owner = this;
+			t_worker_index = index;
+
+			while (true) {
+				if (auto work = pop(index)) {
+					(*work)();
+					continue;
+				}
+
+				std::unique_lock lock(m_sleep_mutex);
+				m_sleep_cv.wait(lock, [this]() { return m_stopping || m_queued.load(std::memory_order_acquire) != 0; });
+
+				if (m_stopping) {
+					return;
+				}
+			}
+		}
+
+		std::vector<std::unique_ptr<queue>> m_queues;
+		std::vector<std::thread> m_workers;
+		std::atomic<std::size_t> m_queued{ 0 };
+		std::atomic<std::size_t> m_next_queue{ 0 };
+
+		std::mutex m_sleep_mutex;
+		std::condition_variable m_sleep_cv;
+		bool m_stopping = false;
+
+		static inline thread_local const thread_pool* t_owner = nullptr;
+		static inline thread_local std::size_t t_worker_index = 0;
+	};
+}
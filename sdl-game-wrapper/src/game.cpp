@@ -3,16 +3,42 @@
 namespace sgw {
 	void game::signal_quit() noexcept { m_should_run = false; }
 
+	void game::open_input_log(const game_parameters& params) {
+		if (!params.replay_input_path.empty()) {
+			m_input_replayer.emplace(std::string(params.replay_input_path));
+			m_game_time_step = m_input_replayer->get_time_step();
+			random::seed(m_input_replayer->get_seed());
+			return;
+		}
+
+		auto seed = params.random_seed;
+		if (!params.record_input_path.empty() && !seed) {
+			seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+		}
+
+		if (seed) {
+			random::seed(*seed);
+		}
+
+		if (!params.record_input_path.empty()) {
+			m_input_recorder.emplace(std::string(params.record_input_path), *seed, m_game_time_step);
+		}
+	}
+
 	void game::start() {
 		try {
+			profiling::profiler::instance().set_thread_name("main");
 			game_preload();
 
 			m_delta_time = m_game_time_step;
-			auto time_start = std::chrono::system_clock::now();
+			auto time_start = std::chrono::steady_clock::now();
 			auto accumulator = 0.0;
 
 			while (m_should_run) {
-				auto time_now = std::chrono::system_clock::now();
+				m_frame_arenas.reset();
+				profiling::scoped_zone frame_zone("frame", &m_frame_stats.frame);
+
+				auto time_now = std::chrono::steady_clock::now();
 				std::chrono::duration<double> frame_time = time_now - time_start;
 				auto frame_time_val = frame_time.count();
 
@@ -23,13 +49,61 @@ namespace sgw {
 				time_start = time_now;
 				accumulator += frame_time_val;
 
-				while (accumulator >= m_delta_time) {
-					logic();
-					accumulator -= m_delta_time;
+				{
+					profiling::scoped_zone logic_zone("logic", &m_frame_stats.logic);
+
+					std::uint64_t ticks = 0;
+					if (m_input_replayer && m_replay_mode != replay_mode::realtime) {
+						// straight on to the tick of the next recorded poll
+						auto target = m_input_replayer->is_finished() ? m_input_replayer->get_end_tick() : m_input_replayer->get_next_tick();
+						ticks = target > m_tick ? target - m_tick : 0;
+						accumulator = 0.0;
+					}
+					else {
+						while (accumulator >= m_delta_time) {
+							accumulator -= m_delta_time;
+							ticks++;
+						}
+					}
+
+					for (; ticks > 0; ticks--) {
+						// a recorded poll happened after exactly this many ticks, so it has to land
+						// between the same two ticks even when one frame runs several
+						if (m_input_replayer) {
+							replay_events();
+						}
+
+						if (!m_should_run) {
+							break;
+						}
+
+						logic();
+						m_input.end_tick();
+						m_tick++;
+					}
+				}
+
+				{
+					profiling::scoped_zone events_zone("poll_events", &m_frame_stats.events);
+					poll_events();
+				}
+
+				if (!m_asset_loader.is_idle()) {
+					m_asset_loader.update(m_image_manager, m_font_manager, m_renderer, m_asset_upload_budget);
+				}
+
+				if (!m_input_replayer || m_replay_mode != replay_mode::headless) {
+					draw();
 				}
+				m_texture_cache.end_frame();
 
-				poll_events();
-				draw();
+				if (!m_input_replayer || m_replay_mode == replay_mode::realtime) {
+					m_frame_pacer.wait();
+				}
+			}
+
+			if (m_input_recorder) {
+				m_input_recorder->finish(m_tick);
 			}
 		}
 		catch (const std::exception& ex) {
@@ -39,28 +113,107 @@ namespace sgw {
 
 	void game::logic() {
 		game_logic();
+		m_systems.run(m_entity_registry, m_delta_time);
 	}
 	
 	void game::draw() {
-		m_renderer.clear();
-		game_draw(m_renderer);
+		{
+			profiling::scoped_zone draw_zone("draw", &m_frame_stats.draw);
+			m_renderer.clear();
+			m_layers.draw_below(layer_stack::game_order);
+			game_draw(m_renderer);
+			m_layers.draw_from(layer_stack::game_order);
+		}
+
+		profiling::scoped_zone present_zone("present", &m_frame_stats.present);
 		m_renderer.present();
 	}
 	
 	void game::poll_events() {
 		SDL_Event sdl_event;
 
-		if (SDL_PollEvent(&sdl_event) == 1) {
+		if (m_input_replayer) {
+			// live input is ignored while replaying, apart from closing the window
+			while (SDL_PollEvent(&sdl_event) == 1) {
+				if (sdl_event.type == SDL_QUIT) {
+					m_should_run = false;
+				}
+			}
+
+			replay_events();
+			return;
+		}
+
+		m_frame_events.clear();
 
-			if (sdl_event.type == SDL_QUIT) {
+		while (SDL_PollEvent(&sdl_event) == 1) {
+			if (sdl_event.type == SDL_MOUSEMOTION && !m_frame_events.empty() && m_frame_events.back().type == SDL_MOUSEMOTION) {
+				auto& previous = m_frame_events.back().motion;
+				previous.timestamp = sdl_event.motion.timestamp;
+				previous.state = sdl_event.motion.state;
+				previous.x = sdl_event.motion.x;
+				previous.y = sdl_event.motion.y;
+				previous.xrel += sdl_event.motion.xrel;
+				previous.yrel += sdl_event.motion.yrel;
+				continue;
+			}
+
+			m_frame_events.push_back(sdl_event);
+		}
+
+		if (m_input_recorder) {
+			m_input_recorder->record(m_tick, m_frame_events);
+		}
+
+		dispatch_events();
+	}
+
+	void game::replay_events() {
+		while (m_input_replayer->is_due(m_tick)) {
+			m_input_replayer->read(m_frame_events);
+			dispatch_events();
+		}
+
+		// the ticks after the last recorded input still have to run
+		if (m_input_replayer->is_finished() && m_tick >= m_input_replayer->get_end_tick()) {
+			m_should_run = false;
+		}
+	}
+
+	void game::dispatch_events() {
+		for (const auto& event : m_frame_events) {
+			m_input.process(event);
+
+			if (event.type == SDL_QUIT) {
 				m_should_run = false;
 			}
-			else if (sdl_event.type == SDL_MOUSEMOTION) {
-				m_mouse_position.first = sdl_event.motion.x;
-				m_mouse_position.second = sdl_event.motion.y;
+			else if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET) {
+				m_layers.invalidate();
+			}
+		}
+
+		m_mouse_position = m_input.get_mouse_position();
+
+		if (!m_frame_events.empty()) {
+			handle_events(m_frame_events);
+		}
+	}
+
+	void game::handle_events(const std::vector<SDL_Event>& events) {
+		for (const auto& event : events) {
+			switch (event.type) {
+			case SDL_KEYDOWN: on_key_down(event.key); break;
+			case SDL_KEYUP: on_key_up(event.key); break;
+			case SDL_MOUSEMOTION: on_mouse_motion(event.motion); break;
+			case SDL_MOUSEBUTTONDOWN: on_mouse_button_down(event.button); break;
+			case SDL_MOUSEBUTTONUP: on_mouse_button_up(event.button); break;
+			case SDL_MOUSEWHEEL: on_mouse_wheel(event.wheel); break;
+			case SDL_TEXTINPUT: on_text_input(event.text); break;
+			case SDL_WINDOWEVENT: on_window_event(event.window); break;
+			default: break;
 			}
 
-			handle_event(sdl_event);
+			handle_event(event);
 		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include <SDL.h>
+#include <SDL_image.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "sdl/asset_pack.h"
+
+namespace {
+	namespace fs = std::filesystem;
+
+	struct packed_asset {
+		std::string name;
+		sgw::asset_pack_entry entry{};
+		std::vector<char> data;
+	};
+
+	std::string lower_extension(const fs::path& path) {
+		auto extension = path.extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return extension;
+	}
+
+	bool is_font(const fs::path& path) {
+		auto extension = lower_extension(path);
+		return extension == ".ttf" || extension == ".otf" || extension == ".fon";
+	}
+
+	// only used to filter directory contents, files named explicitly are always packed
+	bool is_image(const fs::path& path) {
+		auto extension = lower_extension(path);
+		for (std::string_view known : { ".png", ".jpg", ".jpeg", ".bmp", ".tga", ".gif", ".webp", ".tif", ".tiff" }) {
+			if (extension == known) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	Uint32 parse_format(std::string_view name) {
+		if (name == "argb8888") {
+			return SDL_PIXELFORMAT_ARGB8888;
+		}
+		if (name == "abgr8888") {
+			return SDL_PIXELFORMAT_ABGR8888;
+		}
+		if (name == "rgba8888") {
+			return SDL_PIXELFORMAT_RGBA8888;
+		}
+		if (name == "bgra8888") {
+			return SDL_PIXELFORMAT_BGRA8888;
+		}
+		return SDL_PIXELFORMAT_UNKNOWN;
+	}
+
+	packed_asset pack_font(const fs::path& path) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			throw std::runtime_error(path.string() + ": could not open font file");
+		}
+
+		packed_asset asset;
+		asset.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		asset.entry.type = sgw::asset_pack_entry_type::font;
+		return asset;
+	}
+
+	// decodes once here so the game can hand the pixels to SDL as they are
+	packed_asset pack_image(const fs::path& path, Uint32 format) {
+		auto* loaded = IMG_Load(path.string().c_str());
+		if (loaded == nullptr) {
+			throw std::runtime_error(path.string() + ": " + IMG_GetError());
+		}
+
+		auto* converted = SDL_ConvertSurfaceFormat(loaded, format, 0);
+		SDL_FreeSurface(loaded);
+		if (converted == nullptr) {
+			throw std::runtime_error(path.string() + ": " + SDL_GetError());
+		}
+
+		auto row_size = static_cast<std::size_t>(converted->w) * SDL_BYTESPERPIXEL(format);
+
+		packed_asset asset;
+		asset.entry.type = sgw::asset_pack_entry_type::image;
+		asset.entry.format = format;
+		asset.entry.width = converted->w;
+		asset.entry.height = converted->h;
+		asset.entry.pitch = static_cast<std::int32_t>(row_size);
+		asset.data.resize(row_size * static_cast<std::size_t>(converted->h));
+
+		SDL_LockSurface(converted);
+		for (int y = 0; y < converted->h; y++) {
+			std::memcpy(asset.data.data() + row_size * static_cast<std::size_t>(y), static_cast<const char*>(converted->pixels) + static_cast<std::ptrdiff_t>(y) * converted->pitch, row_size);
+		}
+		SDL_UnlockSurface(converted);
+		SDL_FreeSurface(converted);
+
+		return asset;
+	}
+
+	std::uint64_t align(std::uint64_t offset) {
+		return (offset + sgw::asset_pack_alignment - 1) / sgw::asset_pack_alignment * sgw::asset_pack_alignment;
+	}
+
+	void write_pack(const std::string& output, std::vector<packed_asset>& assets) {
+		std::sort(assets.begin(), assets.end(), [](const auto& a, const auto& b) { return a.name < b.name; });
+
+		auto duplicate = std::adjacent_find(assets.begin(), assets.end(), [](const auto& a, const auto& b) { return a.name == b.name; });
+		if (duplicate != assets.end()) {
+			throw std::runtime_error(duplicate->name + ": packed twice");
+		}
+
+		std::string names;
+		for (auto& asset : assets) {
+			asset.entry.name_offset = static_cast<std::uint32_t>(names.size());
+			asset.entry.name_size = static_cast<std::uint32_t>(asset.name.size());
+			names += asset.name;
+		}
+
+		sgw::asset_pack_header header{
+			.magic = sgw::asset_pack_header::expected_magic,
+			.version = sgw::asset_pack_header::current_version,
+			.entry_count = static_cast<std::uint32_t>(assets.size()),
+			.names_size = static_cast<std::uint32_t>(names.size())
+		};
+
+		auto offset = align(sizeof(header) + assets.size() * sizeof(sgw::asset_pack_entry) + names.size());
+		for (auto& asset : assets) {
+			asset.entry.data_offset = offset;
+			asset.entry.data_size = asset.data.size();
+			offset = align(offset + asset.data.size());
+		}
+
+		std::ofstream file(output, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			throw std::runtime_error(output + ": could not open for writing");
+		}
+
+		auto pad_to = [&file](std::uint64_t position) {
+			static constexpr char zeros[sgw::asset_pack_alignment]{};
+			auto current = static_cast<std::uint64_t>(file.tellp());
+			file.write(zeros, static_cast<std::streamsize>(position - current));
+		};
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		for (const auto& asset : assets) {
+			file.write(reinterpret_cast<const char*>(&asset.entry), sizeof(asset.entry));
+		}
+		file.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+		for (const auto& asset : assets) {
+			pad_to(asset.entry.data_offset);
+			file.write(asset.data.data(), static_cast<std::streamsize>(asset.data.size()));
+		}
+		pad_to(offset);
+
+		if (!file) {
+			throw std::runtime_error(output + ": write failed");
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	std::string output;
+	fs::path root = ".";
+	Uint32 format = SDL_PIXELFORMAT_ARGB8888;
+	std::vector<fs::path> inputs;
+
+	for (int i = 1; i < argc; i++) {
+		std::string_view arg = argv[i];
+		auto value = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+
+		if (arg == "-o" || arg == "--output") {
+			output = value();
+		}
+		else if (arg == "--root") {
+			root = value();
+		}
+		else if (arg == "--format") {
+			format = parse_format(value());
+		}
+		else if (!arg.starts_with("-")) {
+			inputs.emplace_back(arg);
+		}
+		else {
+			output.clear();
+			break;
+		}
+	}
+
+	if (output.empty() || inputs.empty() || format == SDL_PIXELFORMAT_UNKNOWN) {
+		std::cerr << "usage: " << argv[0] << " -o pack.sgwpack [--root dir] [--format argb8888|abgr8888|rgba8888|bgra8888] files or directories...\n"
+			<< "assets are named by their path relative to --root, which is what image_manager::add_image and font_manager::add_font are called with\n";
+		return 1;
+	}
+
+	try {
+		if (IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG) == 0) {
+			throw std::runtime_error(IMG_GetError());
+		}
+
+		std::vector<fs::path> files;
+		for (const auto& input : inputs) {
+			if (fs::is_directory(input)) {
+				for (const auto& item : fs::recursive_directory_iterator(input)) {
+					if (item.is_regular_file() && (is_image(item.path()) || is_font(item.path()))) {
+						files.push_back(item.path());
+					}
+				}
+			}
+			else {
+				files.push_back(input);
+			}
+		}
+
+		std::vector<packed_asset> assets;
+		std::uint64_t pixel_bytes = 0;
+		for (const auto& path : files) {
+			auto asset = is_font(path) ? pack_font(path) : pack_image(path, format);
+			asset.name = fs::relative(path, root).generic_string();
+			pixel_bytes += asset.data.size();
+			assets.push_back(std::move(asset));
+		}
+
+		write_pack(output, assets);
+		std::cout << "packed " << assets.size() << " assets (" << pixel_bytes / 1024 << " KiB) into " << output << '\n';
+
+		IMG_Quit();
+	}
+	catch (const std::exception& ex) {
+		std::cerr << ex.what() << '\n';
+		return 1;
+	}
+
+	return 0;
+}